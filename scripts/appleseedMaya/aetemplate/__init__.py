@@ -26,6 +26,7 @@
 #
 
 import maya.cmds as mc
+import maya.mel as mel
 import pymel.core as pm
 
 # appleseedMaya imports.
@@ -80,3 +81,21 @@ class AEappleseedNodeTemplate(pm.ui.AETemplate):
 
 def appleseedAETemplateCallback(nodeName):
     AEappleseedNodeTemplate(nodeName)
+
+def createAETemplateMelProcedures():
+    # Generic AE template for OSL shading nodes.
+    # The layout procedure of each node type is built by the plugin
+    # the first time the attribute editor is shown for that type.
+    mel.eval('''
+        global proc AEappleseedShaderTemplate(string $nodeName)
+        {
+            string $nodeType = `nodeType $nodeName`;
+            string $layoutProc = "AE" + $nodeType + "Layout";
+
+            if (!`exists $layoutProc`)
+                $layoutProc = `appleseedShadingNodeTemplate $nodeType`;
+
+            eval($layoutProc + " \\"" + $nodeName + "\\"");
+        }
+        '''
+    )
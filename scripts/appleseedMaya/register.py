@@ -36,7 +36,7 @@ import maya.mel as mel
 import maya.OpenMaya as om
 
 # appleseedMaya imports.
-from aetemplate import appleseedAETemplateCallback
+from aetemplate import appleseedAETemplateCallback, createAETemplateMelProcedures
 from hyperShadeCallbacks import *
 from logger import logger
 from menu import createMenu, deleteMenu
@@ -112,6 +112,7 @@ def register():
         )
 
     # AE templates.
+    createAETemplateMelProcedures()
     pm.callbacks(
         addCallback=appleseedAETemplateCallback,
         hook="AETemplateCustomContent",
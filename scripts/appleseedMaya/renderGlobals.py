@@ -284,10 +284,64 @@ class AppleseedRenderGlobalsMainTab(object):
                         self.__addControl(
                             ui=pm.intFieldGrp(label="Render Passes", numberOfFields = 1),
                             attrName="passes")
+
+                        attr = pm.Attribute("appleseedRenderGlobals.renderMode")
+                        menuItems = [(i, v) for i, v in enumerate(attr.getEnums().keys())]
+                        self.__addControl(
+                            ui=pm.attrEnumOptionMenuGrp(label="Render Mode", enumeratedItem=menuItems),
+                            attrName="renderMode")
+                        self.__addControl(
+                            ui=pm.intFieldGrp(label="Time Limit (s)", numberOfFields = 1),
+                            attrName="timeLimit")
+                        self.__addControl(
+                            ui=pm.floatFieldGrp(label="Noise Threshold", numberOfFields = 1),
+                            attrName="noiseThreshold")
+                        self.__addControl(
+                            ui=pm.intFieldGrp(label="Min Pixel Samples", numberOfFields = 1),
+                            attrName="minSamples")
                         self.__addControl(
-                            ui=pm.intFieldGrp(label="Tile Size", numberOfFields = 1),
+                            ui=pm.intFieldGrp(label="Tile Size", numberOfFields = 1, annotation="0 = auto"),
                             attrName="tileSize")
 
+                        attr = pm.Attribute("appleseedRenderGlobals.tileOrdering")
+                        menuItems = [(i, v) for i, v in enumerate(attr.getEnums().keys())]
+                        self.__addControl(
+                            ui=pm.attrEnumOptionMenuGrp(label="Tile Ordering", enumeratedItem=menuItems),
+                            attrName="tileOrdering")
+
+                        attr = pm.Attribute("appleseedRenderGlobals.pixelFormat")
+                        menuItems = [(i, v) for i, v in enumerate(attr.getEnums().keys())]
+                        self.__addControl(
+                            ui=pm.attrEnumOptionMenuGrp(label="Pixel Format", enumeratedItem=menuItems),
+                            attrName="pixelFormat")
+                        self.__addControl(
+                            ui=pm.checkBoxGrp(label="Priority Region"),
+                            attrName="priorityRegion")
+                        self.__addControl(
+                            ui=pm.floatFieldGrp(label="Priority Region Left", numberOfFields = 1),
+                            attrName="priorityRegionLeft")
+                        self.__addControl(
+                            ui=pm.floatFieldGrp(label="Priority Region Right", numberOfFields = 1),
+                            attrName="priorityRegionRight")
+                        self.__addControl(
+                            ui=pm.floatFieldGrp(label="Priority Region Bottom", numberOfFields = 1),
+                            attrName="priorityRegionBottom")
+                        self.__addControl(
+                            ui=pm.floatFieldGrp(label="Priority Region Top", numberOfFields = 1),
+                            attrName="priorityRegionTop")
+
+                        attr = pm.Attribute("appleseedRenderGlobals.renderViewTransform")
+                        menuItems = [(i, v) for i, v in enumerate(attr.getEnums().keys())]
+                        self.__addControl(
+                            ui=pm.attrEnumOptionMenuGrp(
+                                label="Render View Transform",
+                                enumeratedItem=menuItems,
+                                annotation="Disable the render view color management when using a view transform"),
+                            attrName="renderViewTransform")
+                        self.__addControl(
+                            ui=pm.floatFieldGrp(label="Render View Exposure", numberOfFields = 1),
+                            attrName="renderViewExposure")
+
                 with pm.frameLayout(label="Shading", collapsable=True, collapse=False):
                     with pm.columnLayout("appleseedColumnLayout", adjustableColumn=True, width=columnWidth):
                         attr = pm.Attribute("appleseedRenderGlobals.diagnostics")
@@ -336,11 +390,79 @@ class AppleseedRenderGlobalsMainTab(object):
                             ui=pm.checkBoxGrp(label="Background Emits Light"),
                             attrName="bgLight")
 
+                with pm.frameLayout(label="AOVs", collapsable=True, collapse=False):
+                    with pm.columnLayout("appleseedColumnLayout", adjustableColumn=True, width=columnWidth):
+                        self.__addControl(
+                            ui=pm.checkBoxGrp(label="Diffuse"),
+                            attrName="diffuseAOV")
+                        self.__addControl(
+                            ui=pm.checkBoxGrp(label="Glossy"),
+                            attrName="glossyAOV")
+                        self.__addControl(
+                            ui=pm.checkBoxGrp(label="Emission"),
+                            attrName="emissionAOV")
+                        self.__addControl(
+                            ui=pm.checkBoxGrp(label="Depth"),
+                            attrName="depthAOV")
+                        self.__addControl(
+                            ui=pm.checkBoxGrp(label="Normal"),
+                            attrName="normalAOV")
+                        self.__addControl(
+                            ui=pm.checkBoxGrp(label="Albedo"),
+                            attrName="albedoAOV")
+
+                with pm.frameLayout(label="OpenEXR", collapsable=True, collapse=True):
+                    with pm.columnLayout("appleseedColumnLayout", adjustableColumn=True, width=columnWidth):
+                        attr = pm.Attribute("appleseedRenderGlobals.exrCompression")
+                        menuItems = [(i, v) for i, v in enumerate(attr.getEnums().keys())]
+                        self.__addControl(
+                            ui=pm.attrEnumOptionMenuGrp(label="Compression", enumeratedItem=menuItems),
+                            attrName="exrCompression")
+                        self.__addControl(
+                            ui=pm.checkBoxGrp(label="Tiled"),
+                            attrName="exrTiled")
+
                 with pm.frameLayout(label="System", collapsable=True, collapse=False):
                     with pm.columnLayout("appleseedColumnLayout", adjustableColumn=True, width=columnWidth):
                         self.__addControl(
                             ui=pm.intFieldGrp(label="Threads", numberOfFields = 1),
                             attrName="threads")
+                        self.__addControl(
+                            ui=pm.checkBoxGrp(label="Render Out of Process"),
+                            attrName="outOfProcess")
+
+                        attr = pm.Attribute("appleseedRenderGlobals.processPriority")
+                        menuItems = [(i, v) for i, v in enumerate(attr.getEnums().keys())]
+                        self.__addControl(
+                            ui=pm.attrEnumOptionMenuGrp(label="Process Priority", enumeratedItem=menuItems),
+                            attrName="processPriority")
+
+                        attr = pm.Attribute("appleseedRenderGlobals.batchMode")
+                        menuItems = [(i, v) for i, v in enumerate(attr.getEnums().keys())]
+                        self.__addControl(
+                            ui=pm.attrEnumOptionMenuGrp(label="Batch Mode", enumeratedItem=menuItems),
+                            attrName="batchMode")
+                        self.__addControl(
+                            ui=pm.intFieldGrp(label="Batch Processes", numberOfFields = 1),
+                            attrName="batchProcesses")
+                        self.__addControl(
+                            ui=pm.intFieldGrp(label="Threads per Process", numberOfFields = 1),
+                            attrName="batchProcessThreads")
+                        self.__addControl(
+                            ui=pm.checkBoxGrp(label="Distribute Frame", annotation="Ignored when AOVs are enabled"),
+                            attrName="distributeFrame")
+                        self.__addControl(
+                            ui=pm.intFieldGrp(label="Frame Processes", numberOfFields = 1),
+                            attrName="frameWorkers")
+                        self.__addControl(
+                            ui=pm.checkBoxGrp(label="Checkpoint"),
+                            attrName="checkpoint")
+                        self.__addControl(
+                            ui=pm.intFieldGrp(label="Checkpoint Interval (s)", numberOfFields = 1),
+                            attrName="checkpointInterval")
+                        self.__addControl(
+                            ui=pm.checkBoxGrp(label="Resume from Checkpoint"),
+                            attrName="resumeCheckpoint")
 
         pm.setUITemplate("renderGlobalsTemplate", popTemplate=True)
         pm.setUITemplate("attributeEditorTemplate", popTemplate=True)
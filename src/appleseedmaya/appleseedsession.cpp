@@ -30,6 +30,10 @@
 #include "appleseedmaya/appleseedsession.h"
 
 // Standard headers.
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <string>
 #include <vector>
 
 // Boost headers.
@@ -40,6 +44,7 @@
 #include "boost/shared_ptr.hpp"
 #include "boost/scoped_ptr.hpp"
 #include "boost/thread/thread.hpp"
+#include "boost/unordered_map.hpp"
 
 // Maya headers.
 #include <maya/MAnimControl.h>
@@ -53,9 +58,15 @@
 #include <maya/MSelectionList.h>
 #include <maya/MObject.h>
 #include <maya/MObjectArray.h>
+#include <maya/MObjectHandle.h>
 #include <maya/MRenderUtil.h>
 
 // appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/color.h"
+#include "foundation/image/image.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/scalar.h"
 #include "foundation/platform/timers.h"
 #include "foundation/utility/autoreleaseptr.h"
 #include "foundation/utility/iostreamop.h"
@@ -65,6 +76,7 @@
 #include "foundation/utility/string.h"
 
 // appleseed.renderer headers.
+#include "renderer/api/aov.h"
 #include "renderer/api/environment.h"
 #include "renderer/api/frame.h"
 #include "renderer/api/material.h"
@@ -75,17 +87,31 @@
 
 // appleseed.maya headers.
 #include "appleseedmaya/attributeutils.h"
+#include "appleseedmaya/displaytransform.h"
+#include "appleseedmaya/entitynames.h"
 #include "appleseedmaya/exceptions.h"
 #include "appleseedmaya/exporters/dagnodeexporter.h"
 #include "appleseedmaya/exporters/exporterfactory.h"
 #include "appleseedmaya/exporters/shadingengineexporter.h"
 #include "appleseedmaya/exporters/shadingnetworkexporter.h"
 #include "appleseedmaya/exporters/shapeexporter.h"
+#include "appleseedmaya/framecheckpoint.h"
 #include "appleseedmaya/idlejobqueue.h"
 #include "appleseedmaya/logger.h"
+#include "appleseedmaya/murmurhash.h"
 #include "appleseedmaya/renderercontroller.h"
 #include "appleseedmaya/renderglobalsnode.h"
 #include "appleseedmaya/renderviewtilecallback.h"
+#include "appleseedmaya/shadingnetworkhasher.h"
+#include "appleseedmaya/tiledexrwriter.h"
+#ifdef APPLESEED_MAYA_WITH_RENDER_PROCESS
+#include "appleseedmaya/numautils.h"
+#include "appleseedmaya/renderprocess.h"
+#include "appleseedmaya/sharedtilebuffer.h"
+
+// POSIX headers.
+#include <unistd.h>
+#endif
 
 namespace bfs = boost::filesystem;
 namespace asf = foundation;
@@ -102,6 +128,89 @@ Services::~Services() {}
 namespace
 {
 
+bfs::path g_pluginPath; // Plugin path.
+
+#ifdef APPLESEED_MAYA_WITH_RENDER_PROCESS
+// Return the path to the render process executable, or an empty path if it is missing.
+bfs::path renderProcessExecutable()
+{
+    const bfs::path executable = g_pluginPath / "appleseedMayaRender";
+    if (!bfs::exists(executable))
+    {
+        RENDERER_LOG_ERROR(
+            "appleseedMaya: render process executable %s not found",
+            executable.string().c_str());
+        return bfs::path();
+    }
+
+    return executable;
+}
+
+// Return the path of the appleseed project schema used by render processes.
+bfs::path renderProcessSchema()
+{
+    const bfs::path schema = g_pluginPath / "schemas" / "project.xsd";
+    if (!bfs::exists(schema))
+    {
+        RENDERER_LOG_ERROR(
+            "appleseedMaya: appleseed project schema %s not found",
+            schema.string().c_str());
+        return bfs::path();
+    }
+
+    return schema;
+}
+
+// Create a temporary directory for render process projects. Return an empty path on failure.
+bfs::path createRenderProcessDirectory()
+{
+    boost::system::error_code ec;
+    const bfs::path dir = bfs::temp_directory_path(ec) / bfs::unique_path("appleseedmaya-%%%%-%%%%-%%%%");
+    if (ec || !bfs::create_directories(dir, ec))
+    {
+        RENDERER_LOG_ERROR("appleseedMaya: could not create render process directory");
+        return bfs::path();
+    }
+
+    return dir;
+}
+#endif
+
+// Hash function for dependency node handles.
+struct MObjectHandleHash
+{
+    size_t operator()(const MObjectHandle& handle) const
+    {
+        return handle.hashCode();
+    }
+};
+
+// Identifies an instance of a dag node without building its full path name.
+struct DagInstanceKey
+{
+    explicit DagInstanceKey(const MDagPath& path)
+      : m_node(path.node())
+      , m_instance(path.instanceNumber())
+    {
+    }
+
+    bool operator==(const DagInstanceKey& other) const
+    {
+        return m_instance == other.m_instance && m_node == other.m_node;
+    }
+
+    MObjectHandle   m_node;
+    unsigned int    m_instance;
+};
+
+struct DagInstanceKeyHash
+{
+    size_t operator()(const DagInstanceKey& key) const
+    {
+        return key.m_node.hashCode() * 31 + key.m_instance;
+    }
+};
+
 struct ScopedEndSession
 {
     ~ScopedEndSession()
@@ -125,10 +234,10 @@ struct SessionImpl
 
         virtual ShadingEngineExporterPtr createShadingEngineExporter(const MObject& object) const
         {
-            MFnDependencyNode depNodeFn(object);
+            const MObjectHandle handle(object);
 
             ShadingEngineExporterMap::iterator it =
-                m_self.m_shadingEngineExporters.find(depNodeFn.name());
+                m_self.m_shadingEngineExporters.find(handle);
 
             if (it != m_self.m_shadingEngineExporters.end())
                 return it->second;
@@ -137,8 +246,8 @@ struct SessionImpl
                 NodeExporterFactory::createShadingEngineExporter(
                     object,
                     *m_self.mainAssembly(),
-                    m_self.m_sessionMode));
-            m_self.m_shadingEngineExporters[depNodeFn.name()] = exporter;
+                    m_self.exporterSessionMode()));
+            m_self.m_shadingEngineExporters[handle] = exporter;
             return exporter;
         }
 
@@ -147,10 +256,10 @@ struct SessionImpl
             const MObject&                object,
             const MPlug&                  outputPlug) const
         {
-            MFnDependencyNode depNodeFn(object);
+            const MObjectHandle handle(object);
 
             ShadingNetworkExporterMap::iterator it =
-                m_self.m_shadingNetworkExporters[context].find(depNodeFn.name());
+                m_self.m_shadingNetworkExporters[context].find(handle);
 
             if (it != m_self.m_shadingNetworkExporters[context].end())
                 return it->second;
@@ -161,8 +270,8 @@ struct SessionImpl
                     object,
                     outputPlug,
                     *m_self.mainAssembly(),
-                    m_self.m_sessionMode));
-            m_self.m_shadingNetworkExporters[context][depNodeFn.name()] = exporter;
+                    m_self.exporterSessionMode()));
+            m_self.m_shadingNetworkExporters[context][handle] = exporter;
             return exporter;
         }
 
@@ -178,6 +287,14 @@ struct SessionImpl
       , m_options(options)
       , m_services(*this)
       , m_computation(computation)
+      , m_incremental(false)
+      , m_frameWorkers(0)
+      , m_processNiceness(0)
+      , m_checkpointEnabled(false)
+      , m_checkpointInterval(0)
+      , m_resumeCheckpoint(false)
+      , m_checkpointPasses(0)
+      , m_timeLimit(0.0)
     {
         createProject(options.m_colorspace);
     }
@@ -192,6 +309,14 @@ struct SessionImpl
       , m_services(*this)
       , m_computation(computation)
       , m_fileName(fileName)
+      , m_incremental(false)
+      , m_frameWorkers(0)
+      , m_processNiceness(0)
+      , m_checkpointEnabled(false)
+      , m_checkpointInterval(0)
+      , m_resumeCheckpoint(false)
+      , m_checkpointPasses(0)
+      , m_timeLimit(0.0)
     {
         m_projectPath = bfs::path(fileName.asChar()).parent_path();
 
@@ -216,6 +341,10 @@ struct SessionImpl
     ~SessionImpl()
     {
         abortRender();
+
+#ifdef APPLESEED_MAYA_WITH_RENDER_PROCESS
+        removeRenderProcessFiles();
+#endif
     }
 
     void createProject(const char* colorspace)
@@ -280,6 +409,9 @@ struct SessionImpl
 
     void exportProject()
     {
+        // Node types may have been reloaded since the previous export.
+        AttributeUtils::clearAttributeCache();
+
         exportDefaultRenderGlobals();
         MObject globalsNode = exportAppleseedRenderGlobals();
 
@@ -360,10 +492,24 @@ struct SessionImpl
         MFnDependencyNode fnDepNode(globalsNode);
         int tileSize;
         if (AttributeUtils::get(fnDepNode, "tileSize", tileSize))
+        {
+            if (tileSize == 0)
+                tileSize = autoTileSize(fnDepNode);
+
             params.insert("tile_size", asf::Vector2i(tileSize));
+        }
+
+        // Set the pixel format. Half floats halve the frame memory and
+        // are written as is to OpenEXR files.
+        int pixelFormat = 0;
+        AttributeUtils::get(fnDepNode, "pixelFormat", pixelFormat);
+        params.insert("pixel_format", pixelFormat == 1 ? "half" : "float");
 
         // Replace the frame.
-        m_project->set_frame(asr::FrameFactory().create("beauty", params));
+        readAOVs(fnDepNode);
+        asr::AOVContainer aovs;
+        createAOVs(aovs);
+        m_project->set_frame(asr::FrameFactory().create("beauty", params, aovs));
 
         // Set the crop window.
         if (m_options.m_renderRegion)
@@ -373,6 +519,86 @@ struct SessionImpl
                     asf::Vector2u(m_options.m_xmin, m_options.m_ymin),
                     asf::Vector2u(m_options.m_xmax, m_options.m_ymax)));
         }
+
+        readRenderProcessSettings(globalsNode);
+        readCheckpointSettings(globalsNode);
+        readTimeLimit(globalsNode);
+        readExrOptions(globalsNode);
+
+        if (m_incremental)
+            storeFrameHashes();
+    }
+
+    // Read the enabled AOVs from the render globals.
+    void readAOVs(const MFnDependencyNode& globals)
+    {
+        const char* aovNames[] = { "diffuse", "glossy", "emission", "depth", "normal", "albedo" };
+
+        m_aovModels.clear();
+
+        for (size_t i = 0, e = sizeof(aovNames) / sizeof(aovNames[0]); i < e; ++i)
+        {
+            bool enabled = false;
+            AttributeUtils::get(globals, MString(aovNames[i]) + "AOV", enabled);
+            if (enabled)
+                m_aovModels.push_back(std::string(aovNames[i]) + "_aov");
+        }
+    }
+
+    // Create the AOVs read by readAOVs. Does not use Maya,
+    // so it can be called while rendering in a background thread.
+    void createAOVs(asr::AOVContainer& aovs) const
+    {
+        asr::AOVFactoryRegistrar aovFactoryRegistrar;
+
+        for (size_t i = 0, e = m_aovModels.size(); i < e; ++i)
+        {
+            const asr::IAOVFactory* factory = aovFactoryRegistrar.lookup(m_aovModels[i].c_str());
+
+            if (factory == 0)
+            {
+                RENDERER_LOG_WARNING("appleseedMaya: %s not supported by appleseed.", m_aovModels[i].c_str());
+                continue;
+            }
+
+            aovs.insert(factory->create(asr::ParamArray()));
+        }
+    }
+
+    // Pick a tile size that gives enough tiles to keep all the rendering threads
+    // busy on small renders and crop regions, while keeping the per tile overhead
+    // low on large renders.
+    int autoTileSize(const MFnDependencyNode& globals) const
+    {
+        int threads = 0;
+        AttributeUtils::get(globals, "threads", threads);
+        if (threads <= 0)
+            threads = std::max<int>(boost::thread::hardware_concurrency(), 1);
+
+        int width = m_options.m_width;
+        int height = m_options.m_height;
+        if (m_options.m_renderRegion)
+        {
+            width = m_options.m_xmax - m_options.m_xmin + 1;
+            height = m_options.m_ymax - m_options.m_ymin + 1;
+        }
+
+        // Aim for 4 tiles per thread, so that threads finishing early have work left.
+        const double tileArea = static_cast<double>(width) * height / (4.0 * threads);
+        const int tileSize = asf::clamp(static_cast<int>(std::sqrt(tileArea)) / 8 * 8, 16, 128);
+
+        const int tileCount =
+            ((width + tileSize - 1) / tileSize) *
+            ((height + tileSize - 1) / tileSize);
+
+        RENDERER_LOG_INFO(
+            "appleseedMaya: auto tile size %dx%d, %d tiles for %d rendering threads.",
+            tileSize,
+            tileSize,
+            tileCount,
+            threads);
+
+        return tileSize;
     }
 
     void exportScene()
@@ -421,7 +647,7 @@ struct SessionImpl
         }
 
         // Handle auto-instancing.
-        if (m_sessionMode != AppleseedSession::ProgressiveRenderSession)
+        if (exporterSessionMode() != AppleseedSession::ProgressiveRenderSession)
         {
             RENDERER_LOG_DEBUG("Converting objects to instances");
             convertObjectsToInstances();
@@ -484,18 +710,20 @@ struct SessionImpl
             status = MGlobal::getActiveSelectionList(sel);
 
             MDagPath rootPath, path;
-            MItDag it(MItDag::kBreadthFirst);
+            MItDag it(MItDag::kDepthFirst);
+            DagRenderability renderability;
 
             for(int i = 0, e = sel.length(); i < e; ++i)
             {
                 status = sel.getDagPath(i, rootPath);
                 if (status)
                 {
+                    renderability.reset();
                     for(it.reset(rootPath); !it.isDone(); it.next())
                     {
                         status = it.getPath(path);
                         if (status)
-                            createDagNodeExporter(path);
+                            createDagNodeExporter(path, renderability.visit(path));
                     }
                 }
             }
@@ -505,10 +733,11 @@ struct SessionImpl
             // Create exporters for all the dag nodes in the scene.
             RENDERER_LOG_DEBUG("Creating dag node exporters");
             MDagPath path;
+            DagRenderability renderability;
             for(MItDag it(MItDag::kDepthFirst); !it.isDone(); it.next())
             {
                 it.getPath(path);
-                createDagNodeExporter(path);
+                createDagNodeExporter(path, renderability.visit(path));
             }
         }
 
@@ -530,11 +759,13 @@ struct SessionImpl
             it->second->createExporters(m_services);
     }
 
-    void createDagNodeExporter(const MDagPath& path)
+    // renderable is true if the node and all its parents are renderable.
+    void createDagNodeExporter(const MDagPath& path, const bool renderable)
     {
         checkUserAborted();
 
-        if (m_dagExporters.count(path.fullPathName()) != 0)
+        const DagInstanceKey key(path);
+        if (m_dagExporters.count(key) != 0)
             return;
 
         MFnDagNode dagNodeFn(path);
@@ -549,8 +780,9 @@ struct SessionImpl
         {
             exporter.reset(NodeExporterFactory::createDagNodeExporter(
                 path,
+                renderable,
                 *m_project,
-                m_sessionMode));
+                exporterSessionMode()));
         }
         catch (const NoExporterForNode&)
         {
@@ -562,7 +794,7 @@ struct SessionImpl
 
         if (exporter)
         {
-            m_dagExporters[path.fullPathName()] = exporter;
+            m_dagExporters[key] = exporter;
             RENDERER_LOG_DEBUG(
                 "Created dag exporter for node %s",
                 dagNodeFn.name().asChar());
@@ -601,15 +833,44 @@ struct SessionImpl
 
         // Reset the renderer controller.
         m_rendererController.set_status(asr::IRendererController::ContinueRendering);
+        resetRenderProgress();
 
         // Create the master renderer.
         asr::Configuration *cfg = m_project->configurations().get_by_name("final");
         const asr::ParamArray& params = cfg->get_parameters();
 
+        MObject globalsNode;
+        getDependencyNodeByName("appleseedRenderGlobals", globalsNode);
+
         m_tileCallbackFactory.reset(
             new RenderViewTileCallbackFactory(m_rendererController, m_computation));
         m_tileCallbackFactory->renderViewStart(*m_project->get_frame());
 
+        int viewTransform = 0;
+        AttributeUtils::get(globalsNode, "renderViewTransform", viewTransform);
+        float viewExposure = 0.0f;
+        AttributeUtils::get(globalsNode, "renderViewExposure", viewExposure);
+        m_tileCallbackFactory->setDisplayTransform(
+            DisplayTransform(static_cast<DisplayTransform::Curve>(viewTransform), viewExposure));
+
+#ifdef APPLESEED_MAYA_WITH_RENDER_PROCESS
+        bool outOfProcess = false;
+        AttributeUtils::get(globalsNode, "outOfProcess", outOfProcess);
+
+        if (outOfProcess || m_frameWorkers > 0)
+        {
+            if (startRenderWorkers(std::max<size_t>(m_frameWorkers, 1)))
+            {
+                // Non blocking mode.
+                boost::thread thread(&SessionImpl::renderWorkersFunc, this);
+                m_renderThread.swap(thread);
+                return;
+            }
+
+            RENDERER_LOG_WARNING("appleseedMaya: rendering inside Maya.");
+        }
+#endif
+
         m_renderer.reset(
             new asr::MasterRenderer(
                 *m_project,
@@ -617,153 +878,1028 @@ struct SessionImpl
                 &m_rendererController,
                 static_cast<asr::ITileCallbackFactory*>(m_tileCallbackFactory.get())));
 
+        computeRenderWindows(globalsNode);
+
         // Non blocking mode.
         boost::thread thread(&SessionImpl::renderFunc, this);
         m_renderThread.swap(thread);
     }
 
-    void batchRender()
+    void batchRender(const MString& fileName)
     {
         // Reset the renderer controller.
         m_rendererController.set_status(asr::IRendererController::ContinueRendering);
+        resetRenderProgress();
+
+#ifdef APPLESEED_MAYA_WITH_RENDER_PROCESS
+        if (m_frameWorkers > 0)
+        {
+            m_project->get_frame()->clear_main_and_aov_images();
+
+            // The tiles rendered by the processes are stitched into the frame.
+            if (startRenderWorkers(m_frameWorkers))
+            {
+                collectRenderWorkerTiles();
+                return;
+            }
+
+            RENDERER_LOG_WARNING("appleseedMaya: rendering inside Maya.");
+        }
+#endif
+
+        const bool checkpointed = startCheckpoint(fileName);
 
-        // Create the master renderer.
         asr::Configuration *cfg = m_project->configurations().get_by_name("final");
         const asr::ParamArray& params = cfg->get_parameters();
 
-        m_renderer.reset(
-            new asr::MasterRenderer(
-                *m_project,
-                params,
-                &m_rendererController,
-                static_cast<asr::ITileCallbackFactory*>(0)));
+        // Write tiled OpenEXR images as tiles are rendered. Tiles are rendered once
+        // per pass, they can only be streamed with a single pass, else the images
+        // are written in the background after rendering.
+        const bool streamExr =
+            !checkpointed &&
+            m_exrOptions.m_tiled &&
+            asf::ends_with(fileName.asChar(), ".exr") &&
+            params.get_path_optional<size_t>("generic_frame_renderer.passes", 1) == 1;
+
+        if (streamExr)
+            m_exrWriter.open(fileName.asChar(), *m_project->get_frame(), m_exrOptions);
+
+        // Keep the master renderer when updating the project incrementally,
+        // it only rebuilds what changed since the previous frame.
+        if (m_renderer.get() == 0)
+        {
+            // Create the master renderer.
+            asr::ITileCallbackFactory* tileCallbackFactory = 0;
+
+            if (checkpointed)
+                tileCallbackFactory = m_checkpointTileCallbackFactory.get();
+            else if (streamExr)
+            {
+                m_exrTileCallbackFactory.reset(new TiledExrWriterTileCallbackFactory(m_exrWriter));
+                tileCallbackFactory = m_exrTileCallbackFactory.get();
+            }
+
+            m_renderer.reset(
+                new asr::MasterRenderer(
+                    *m_project,
+                    params,
+                    &m_rendererController,
+                    tileCallbackFactory));
+        }
+        else
+            m_project->get_frame()->clear_main_and_aov_images();
 
         m_renderer->render();
+
+        if (checkpointed)
+            finishCheckpoint();
     }
 
-    void progressiveRender()
+    // Save checkpoints of a multi-pass batch render, and resume it from the
+    // checkpoint of a previous render if there is one.
+    // Returns false if the render is not checkpointed.
+    bool startCheckpoint(const MString& fileName)
     {
-        /*
-        // Reset the renderer controller.
-        m_rendererController->set_status(asr::IRendererController::ContinueRendering);
+        if (!m_checkpointEnabled)
+            return false;
 
-        // Create the master renderer.
-        asr::Configuration *cfg = m_project->configurations().get_by_name("interactive");
-        const asr::ParamArray &params = cfg->get_parameters();
+        asr::ParamArray& params = m_project->configurations().get_by_name("final")->get_parameters();
+        const size_t passes = params.get_path_optional<size_t>("generic_frame_renderer.passes", 1);
 
-        RenderViewTileCallbackFactory tileCallbackFactory;
-        m_renderer.reset( new asr::MasterRenderer(*m_project, params, m_rendererController, &tileCallbackFactory));
-        */
+        if (passes < 2)
+        {
+            RENDERER_LOG_WARNING("appleseedMaya: checkpoints need more than one pass, not saving checkpoints.");
+            return false;
+        }
+
+        m_checkpoint.start(
+            std::string(fileName.asChar()) + ".checkpoint",
+            static_cast<double>(m_checkpointInterval),
+            passes);
+
+        if (m_checkpointTileCallbackFactory.get() == 0)
+            m_checkpointTileCallbackFactory.reset(new FrameCheckpointTileCallbackFactory(m_checkpoint));
+
+        const size_t resumedPasses = m_resumeCheckpoint ? m_checkpoint.resume(*m_project->get_frame()) : 0;
+
+        if (resumedPasses > 0)
+        {
+            // Only render the remaining passes.
+            params.insert_path("generic_frame_renderer.passes", passes - resumedPasses);
+            m_checkpointPasses = passes;
+
+            // Replace the frame, so that the remaining passes use another noise seed than the resumed ones.
+            const asr::Frame* frame = m_project->get_frame();
+            const asf::AABB2u cropWindow = frame->get_crop_window();
+
+            asr::ParamArray frameParams = frame->get_parameters();
+            frameParams.insert(
+                "noise_seed",
+                frameParams.get_optional<size_t>("noise_seed", 0) + resumedPasses);
+
+            asr::AOVContainer aovs;
+            createAOVs(aovs);
+            m_project->set_frame(asr::FrameFactory().create("beauty", frameParams, aovs));
+            m_project->get_frame()->set_crop_window(cropWindow);
+
+            // Create a master renderer for the new frame and pass count.
+            m_renderer.reset();
+        }
+
+        return true;
     }
 
-    void renderFunc()
+    void finishCheckpoint()
     {
-        m_renderer->render();
-        IdleJobQueue::pushJob(&AppleseedSession::endSession);
+        // Keep the checkpoint of aborted renders. Time limited renders are complete.
+        if (m_rendererController.get_status() != asr::IRendererController::AbortRendering)
+            m_checkpoint.finish(*m_project->get_frame());
+
+        // Restore the pass count of resumed renders.
+        if (m_checkpointPasses != 0)
+        {
+            m_project->configurations().get_by_name("final")->get_parameters()
+                .insert_path("generic_frame_renderer.passes", m_checkpointPasses);
+            m_checkpointPasses = 0;
+            m_renderer.reset();
+        }
     }
 
-    void abortRender()
+    // Create exporters that remove their entities from the project when destroyed,
+    // like in IPR sessions, so that the project can be updated between frames.
+    // Must be called before exporting the project.
+    void enableIncrementalUpdates()
     {
-        m_rendererController.set_status(asr::IRendererController::AbortRendering);
-        if (m_renderThread.joinable())
-            m_renderThread.join();
+        assert(m_dagExporters.empty());
+        m_incremental = true;
     }
 
-    bool writeProject() const
+    AppleseedSession::SessionMode exporterSessionMode() const
     {
-        return writeProject(m_fileName.asChar());
+        return m_incremental ? AppleseedSession::ProgressiveRenderSession : m_sessionMode;
     }
 
-    bool writeProject(const char *filename) const
+    void storeFrameHashes()
     {
-        return asr::ProjectFileWriter::write(
-            *m_project,
-            filename,
-            asr::ProjectFileWriter::OmitHandlingAssetFiles |
-            asr::ProjectFileWriter::OmitWritingGeometryFiles);
+        m_sceneStructureHash = sceneStructureHash();
+        m_shadingHash = shadingHash();
+
+        m_dagHashes.clear();
+        for(DagExporterMap::const_iterator it = m_dagExporters.begin(), e = m_dagExporters.end(); it != e; ++it)
+            it->second->hashFrameState(m_dagHashes[it->first]);
     }
 
-    void writeMainImage(const char *filename) const
+    // Update the entities that changed since the previous frame.
+    // Returns false if the scene changed too much and has to be exported again.
+    bool updateAnimatedEntities()
     {
-        const asr::Frame* frame = m_project->get_frame();
-        frame->write_main_image(filename);
+        assert(m_incremental);
+
+        if (sceneStructureHash() != m_sceneStructureHash)
+        {
+            RENDERER_LOG_DEBUG("Batch render: dag nodes changed, exporting the whole scene");
+            return false;
+        }
+
+        if (shadingHash() != m_shadingHash)
+        {
+            RENDERER_LOG_DEBUG("Batch render: shading networks changed, exporting the whole scene");
+            return false;
+        }
+
+        std::vector<MDagPath> changed;
+        for(DagExporterMap::const_iterator it = m_dagExporters.begin(), e = m_dagExporters.end(); it != e; ++it)
+        {
+            MurmurHash hash;
+            it->second->hashFrameState(hash);
+
+            MurmurHash& prevHash = m_dagHashes[it->first];
+            if (hash != prevHash)
+            {
+                changed.push_back(it->second->dagPath());
+                prevHash = hash;
+            }
+        }
+
+        for(size_t i = 0, e = changed.size(); i < e; ++i)
+        {
+            const MDagPath& path = changed[i];
+            if (!path.isValid())
+                return false;
+
+            // Destroying the exporter removes its entities from the project.
+            // The scene structure, including renderability, did not change
+            // so the node is still renderable.
+            const DagInstanceKey key(path);
+            m_dagExporters.erase(key);
+            createDagNodeExporter(path, true);
+
+            DagExporterMap::iterator it = m_dagExporters.find(key);
+            if (it == m_dagExporters.end())
+                return false;
+
+            DagNodeExporter& exporter = *it->second;
+            exporter.createExporters(m_services);
+            exporter.createEntities(m_options);
+
+            if (exporter.supportsMotionBlur())
+            {
+                exporter.exportCameraMotionStep(0.0f);
+                exporter.exportTransformMotionStep(0.0f);
+                exporter.exportShapeMotionStep(0.0f);
+            }
+
+            exporter.flushEntities();
+        }
+
+        RENDERER_LOG_INFO(
+            "Batch render: updated %u of %u dag nodes.",
+            static_cast<unsigned int>(changed.size()),
+            static_cast<unsigned int>(m_dagExporters.size()));
+
+        return true;
     }
 
-    asr::Assembly *mainAssembly()
+    // Hash the dag node instances in the scene, their depth in the depth first
+    // walk, which identifies the hierarchy, and whether they and their parents
+    // are renderable, so that hiding a group invalidates the shapes below it.
+    // Instances are identified as in DagInstanceKey, without building path names.
+    MurmurHash sceneStructureHash() const
     {
-        asr::Scene *scene = m_project->get_scene();
-        return scene->assemblies().get_by_name("assembly");
+        MurmurHash hash;
+        MDagPath path;
+        DagRenderability renderability;
+        const DagInstanceKeyHash keyHash;
+        for(MItDag it(MItDag::kDepthFirst); !it.isDone(); it.next())
+        {
+            it.getPath(path);
+            hash.append(keyHash(DagInstanceKey(path)));
+            hash.append(it.depth());
+            hash.append(renderability.visit(path));
+        }
+
+        return hash;
     }
 
-    void checkUserAborted() const
+    MurmurHash shadingHash() const
     {
-        if (m_computation)
-            m_computation->thowIfInterruptRequested();
+        MurmurHash hash;
+        for(size_t i = 0; i < NumShadingNetworkContexts; ++i)
+        {
+            for(ShadingNetworkExporterMap::const_iterator it = m_shadingNetworkExporters[i].begin(), e = m_shadingNetworkExporters[i].end(); it != e; ++it)
+            {
+                if (it->first.isValid())
+                {
+                    ShadingNetworkHasher hasher(hash);
+                    hasher.hashNode(it->first.object());
+                }
+            }
+        }
+
+        return hash;
     }
 
-    typedef std::map<MString, DagNodeExporterPtr, MStringCompareLess>           DagExporterMap;
-    typedef std::map<MString, ShadingEngineExporterPtr, MStringCompareLess>     ShadingEngineExporterMap;
-    typedef std::map<MString, ShadingNetworkExporterPtr, MStringCompareLess>    ShadingNetworkExporterMap;
-    typedef boost::array<ShadingNetworkExporterMap, NumShadingNetworkContexts>  ShadingNetworkExporterMapArray;
+    void progressiveRender()
+    {
+        /*
+        // Reset the renderer controller.
+        m_rendererController->set_status(asr::IRendererController::ContinueRendering);
 
-    AppleseedSession::SessionMode                           m_sessionMode;
-    AppleseedSession::Options                               m_options;
-    ComputationPtr                                          m_computation;
-    ServicesImpl                                            m_services;
-    MTime                                                   m_savedTime;
+        // Create the master renderer.
+        asr::Configuration *cfg = m_project->configurations().get_by_name("interactive");
+        const asr::ParamArray &params = cfg->get_parameters();
 
-    asf::auto_release_ptr<renderer::Project>                m_project;
+        RenderViewTileCallbackFactory tileCallbackFactory;
+        m_renderer.reset( new asr::MasterRenderer(*m_project, params, m_rendererController, &tileCallbackFactory));
+        */
+    }
 
-    MString                                                 m_fileName;
-    bfs::path                                               m_projectPath;
+    // Reset the progress counters and the time limit of the renderer controller.
+    void resetRenderProgress()
+    {
+        const asr::Frame* frame = m_project->get_frame();
+        const asf::CanvasProperties& frameProps = frame->image().properties();
+        const asf::AABB2u& cropWindow = frame->get_crop_window();
 
-    DagExporterMap                                          m_dagExporters;
-    ShadingEngineExporterMap                                m_shadingEngineExporters;
-    ShadingNetworkExporterMapArray                          m_shadingNetworkExporters;
+        const size_t tileCount =
+            (cropWindow.max.x / frameProps.m_tile_width - cropWindow.min.x / frameProps.m_tile_width + 1) *
+            (cropWindow.max.y / frameProps.m_tile_height - cropWindow.min.y / frameProps.m_tile_height + 1);
 
-    boost::scoped_ptr<asr::MasterRenderer>                  m_renderer;
-    RendererController                                      m_rendererController;
-    asf::auto_release_ptr<RenderViewTileCallbackFactory>    m_tileCallbackFactory;
+        const asr::ParamArray& params = m_project->configurations().get_by_name("final")->get_parameters();
+        const size_t samples = params.get_path_optional<size_t>("uniform_pixel_renderer.samples", 1);
 
-    boost::thread                                           m_renderThread;
-};
+        m_rendererController.reset_progress(tileCount, samples);
+        m_rendererController.set_time_limit(m_timeLimit);
+    }
 
-// Globals.
-bfs::path                       g_pluginPath;    // Plugin path.
-MTime                           g_savedTime;     // Saved time.
-boost::scoped_ptr<SessionImpl>  g_globalSession; // Global session.
+    // Split the crop window so that the priority region is rendered first,
+    // followed by the rest of the frame. The windows are aligned on tiles,
+    // so that tiles are not shared between windows.
+    void computeRenderWindows(const MObject& globalsNode)
+    {
+        m_renderWindows.clear();
 
-} // unnamed
+        bool priorityRegion = false;
+        AttributeUtils::get(globalsNode, "priorityRegion", priorityRegion);
+        if (!priorityRegion)
+            return;
 
-namespace AppleseedSession
-{
+        float left = 0.0f, right = 1.0f, bottom = 0.0f, top = 1.0f;
+        AttributeUtils::get(globalsNode, "priorityRegionLeft", left);
+        AttributeUtils::get(globalsNode, "priorityRegionRight", right);
+        AttributeUtils::get(globalsNode, "priorityRegionBottom", bottom);
+        AttributeUtils::get(globalsNode, "priorityRegionTop", top);
 
-MStatus initialize(const MString& pluginPath)
-{
-    g_pluginPath = pluginPath.asChar();
-    return MS::kSuccess;
-}
+        const asr::Frame* frame = m_project->get_frame();
+        const asf::CanvasProperties& frameProps = frame->image().properties();
+        const asf::AABB2u& dataWindow = frame->get_crop_window();
+
+        const size_t tileWidth = frameProps.m_tile_width;
+        const size_t tileHeight = frameProps.m_tile_height;
+        const float maxX = static_cast<float>(frameProps.m_canvas_width - 1);
+        const float maxY = static_cast<float>(frameProps.m_canvas_height - 1);
+
+        // Convert to pixels, flip vertically (Maya is Y up) and expand to whole tiles.
+        asf::AABB2u region;
+        region.min.x = static_cast<size_t>(asf::saturate(std::min(left, right)) * maxX) / tileWidth * tileWidth;
+        region.max.x = (static_cast<size_t>(asf::saturate(std::max(left, right)) * maxX) / tileWidth + 1) * tileWidth - 1;
+        region.min.y = static_cast<size_t>((1.0f - asf::saturate(std::max(bottom, top))) * maxY) / tileHeight * tileHeight;
+        region.max.y = (static_cast<size_t>((1.0f - asf::saturate(std::min(bottom, top))) * maxY) / tileHeight + 1) * tileHeight - 1;
+
+        region.min.x = std::max(region.min.x, dataWindow.min.x);
+        region.min.y = std::max(region.min.y, dataWindow.min.y);
+        region.max.x = std::min(region.max.x, dataWindow.max.x);
+        region.max.y = std::min(region.max.y, dataWindow.max.y);
+
+        if (region.min.x > region.max.x || region.min.y > region.max.y)
+            return;
 
-MStatus uninitialize()
-{
-    g_globalSession.reset();
-    return MS::kSuccess;
-}
+        if (region.min == dataWindow.min && region.max == dataWindow.max)
+            return;
 
-namespace
-{
+        m_renderWindows.push_back(region);
 
-void beginSession(
-    AppleseedSession::SessionMode       mode,
-    const AppleseedSession::Options&    options,
-    ComputationPtr                      computation)
-{
-    g_globalSession.reset(new SessionImpl(mode, options, computation));
-}
+        // Bands above and below the region.
+        if (region.min.y > dataWindow.min.y)
+        {
+            m_renderWindows.push_back(
+                asf::AABB2u(
+                    dataWindow.min,
+                    asf::Vector2u(dataWindow.max.x, region.min.y - 1)));
+        }
 
-void beginSession(
-    const char*                         fileName,
-    const AppleseedSession::Options&    options,
+        if (region.max.y < dataWindow.max.y)
+        {
+            m_renderWindows.push_back(
+                asf::AABB2u(
+                    asf::Vector2u(dataWindow.min.x, region.max.y + 1),
+                    dataWindow.max));
+        }
+
+        // Bands on the left and on the right of the region.
+        if (region.min.x > dataWindow.min.x)
+        {
+            m_renderWindows.push_back(
+                asf::AABB2u(
+                    asf::Vector2u(dataWindow.min.x, region.min.y),
+                    asf::Vector2u(region.min.x - 1, region.max.y)));
+        }
+
+        if (region.max.x < dataWindow.max.x)
+        {
+            m_renderWindows.push_back(
+                asf::AABB2u(
+                    asf::Vector2u(region.max.x + 1, region.min.y),
+                    asf::Vector2u(dataWindow.max.x, region.max.y)));
+        }
+    }
+
+    void renderFunc()
+    {
+        if (m_renderWindows.empty())
+            m_renderer->render();
+        else
+        {
+            asr::Frame* frame = m_project->get_frame();
+            const asf::AABB2u cropWindow = frame->get_crop_window();
+
+            // In Time Limit mode, each window gets a share of the time limit
+            // proportional to its area. The limits are cumulative, so that
+            // the time left by a window is given to the next ones.
+            std::vector<double> areas(m_renderWindows.size());
+            double totalArea = 0.0;
+
+            for (size_t i = 0, e = m_renderWindows.size(); i < e; ++i)
+            {
+                const asf::AABB2u& window = m_renderWindows[i];
+                areas[i] =
+                    static_cast<double>(window.max.x - window.min.x + 1) *
+                    static_cast<double>(window.max.y - window.min.y + 1);
+                totalArea += areas[i];
+            }
+
+            double renderedArea = 0.0;
+
+            for (size_t i = 0, e = m_renderWindows.size(); i < e; ++i)
+            {
+                if (m_timeLimit > 0.0)
+                {
+                    renderedArea += areas[i];
+                    m_rendererController.set_time_limit(
+                        i + 1 < e ? m_timeLimit * renderedArea / totalArea : m_timeLimit);
+                }
+
+                frame->set_crop_window(m_renderWindows[i]);
+                m_renderer->render();
+
+                if (m_rendererController.get_status() == asr::IRendererController::AbortRendering)
+                    break;
+            }
+
+            frame->set_crop_window(cropWindow);
+        }
+
+        IdleJobQueue::pushJob(&AppleseedSession::endSession);
+    }
+
+    // Read the render globals used by render processes. Must be called after readAOVs().
+    void readRenderProcessSettings(const MObject& globalsNode)
+    {
+        int priority = 1;
+        AttributeUtils::get(globalsNode, "processPriority", priority);
+        const int niceness[] = { 0, 5, 15 };
+        m_processNiceness = niceness[asf::clamp(priority, 0, 2)];
+
+        m_frameWorkers = 0;
+
+#ifdef APPLESEED_MAYA_WITH_RENDER_PROCESS
+        bool distributeFrame = false;
+        AttributeUtils::get(globalsNode, "distributeFrame", distributeFrame);
+
+        // Render processes only send the beauty image back.
+        if (distributeFrame && !m_aovModels.empty())
+        {
+            RENDERER_LOG_WARNING("appleseedMaya: frames with AOVs are not distributed to render processes.");
+            distributeFrame = false;
+        }
+
+        if (distributeFrame)
+        {
+            AttributeUtils::get(globalsNode, "frameWorkers", m_frameWorkers);
+
+            // Default to one process per NUMA node.
+            if (m_frameWorkers <= 0)
+                m_frameWorkers = std::max<int>(static_cast<int>(NumaUtils::nodeCpuLists().size()), 1);
+        }
+#endif
+    }
+
+    void readExrOptions(const MObject& globalsNode)
+    {
+        const char* compressions[] = { "none", "zip", "piz", "dwaa" };
+
+        int compression = 1;
+        AttributeUtils::get(globalsNode, "exrCompression", compression);
+        m_exrOptions.m_compression = compressions[asf::clamp(compression, 0, 3)];
+
+        m_exrOptions.m_tiled = true;
+        AttributeUtils::get(globalsNode, "exrTiled", m_exrOptions.m_tiled);
+    }
+
+    void readTimeLimit(const MObject& globalsNode)
+    {
+        m_timeLimit = 0.0;
+
+        int renderMode = 0;
+        AttributeUtils::get(globalsNode, "renderMode", renderMode);
+
+        if (renderMode == 1)
+        {
+            int timeLimit = 0;
+            AttributeUtils::get(globalsNode, "timeLimit", timeLimit);
+            m_timeLimit = static_cast<double>(timeLimit);
+        }
+    }
+
+    void readCheckpointSettings(const MObject& globalsNode)
+    {
+        m_checkpointEnabled = false;
+        AttributeUtils::get(globalsNode, "checkpoint", m_checkpointEnabled);
+
+        m_checkpointInterval = 600;
+        AttributeUtils::get(globalsNode, "checkpointInterval", m_checkpointInterval);
+
+        m_resumeCheckpoint = false;
+        AttributeUtils::get(globalsNode, "resumeCheckpoint", m_resumeCheckpoint);
+    }
+
+#ifdef APPLESEED_MAYA_WITH_RENDER_PROCESS
+    // Launch render processes, each one rendering a band of whole tile rows of the frame.
+    bool startRenderWorkers(size_t workerCount)
+    {
+        const bfs::path executable = renderProcessExecutable();
+        if (executable.empty())
+            return false;
+
+        const bfs::path schema = renderProcessSchema();
+        if (schema.empty())
+            return false;
+
+        m_renderProcessDir = createRenderProcessDirectory();
+        if (m_renderProcessDir.empty())
+            return false;
+
+        const bfs::path projectPath = m_renderProcessDir / "project.appleseed";
+        if (!writeRenderProcessProject(projectPath))
+        {
+            removeRenderProcessFiles();
+            return false;
+        }
+
+        const asr::Frame* frame = m_project->get_frame();
+        const asf::CanvasProperties& frameProps = frame->image().properties();
+        const asf::AABB2u& dataWindow = frame->get_crop_window();
+
+        const size_t firstRow = dataWindow.min.y / frameProps.m_tile_height;
+        const size_t rowCount = dataWindow.max.y / frameProps.m_tile_height - firstRow + 1;
+        workerCount = std::min(workerCount, rowCount);
+
+        // Pin each process to the CPUs of a NUMA node.
+        std::vector<std::string> nodeCpuLists;
+        if (workerCount > 1)
+            nodeCpuLists = NumaUtils::nodeCpuLists();
+
+        const size_t slotCount = std::max<size_t>(16, 2 * boost::thread::hardware_concurrency());
+
+        for (size_t i = 0; i < workerCount; ++i)
+        {
+            RenderWorker worker;
+            worker.m_window = dataWindow;
+            worker.m_window.min.y = std::max(
+                dataWindow.min.y,
+                (firstRow + i * rowCount / workerCount) * frameProps.m_tile_height);
+            worker.m_window.max.y = std::min(
+                dataWindow.max.y,
+                (firstRow + (i + 1) * rowCount / workerCount) * frameProps.m_tile_height - 1);
+
+            // Create the shared memory tile buffer.
+            static size_t bufferCount = 0;
+            const std::string bufferName =
+                "/appleseedmaya-" +
+                asf::to_string(getpid()) + "-" +
+                asf::to_string(bufferCount++);
+
+            worker.m_tileBuffer.reset(
+                SharedTileBuffer::create(
+                    bufferName,
+                    frameProps.m_canvas_width,
+                    frameProps.m_canvas_height,
+                    frameProps.m_tile_width,
+                    frameProps.m_tile_height,
+                    slotCount));
+
+            if (!worker.m_tileBuffer)
+            {
+                m_renderWorkers.clear();
+                removeRenderProcessFiles();
+                return false;
+            }
+
+            // Launch the render process.
+            std::vector<std::string> args;
+            args.push_back(projectPath.string());
+            args.push_back("--shm");
+            args.push_back(bufferName);
+            args.push_back("--schema");
+            args.push_back(schema.string());
+
+            if (workerCount > 1)
+            {
+                args.push_back("--crop");
+                args.push_back(asf::to_string(worker.m_window.min.x));
+                args.push_back(asf::to_string(worker.m_window.min.y));
+                args.push_back(asf::to_string(worker.m_window.max.x));
+                args.push_back(asf::to_string(worker.m_window.max.y));
+
+                size_t threads = boost::thread::hardware_concurrency() / workerCount;
+
+                if (!nodeCpuLists.empty())
+                {
+                    const size_t nodeCount = nodeCpuLists.size();
+                    const size_t node = i % nodeCount;
+                    const size_t nodeWorkers = workerCount / nodeCount + (node < workerCount % nodeCount ? 1 : 0);
+
+                    std::vector<size_t> cpus;
+                    NumaUtils::parseCpuList(nodeCpuLists[node], cpus);
+                    threads = cpus.size() / nodeWorkers;
+
+                    args.push_back("--cpus");
+                    args.push_back(nodeCpuLists[node]);
+                }
+
+                args.push_back("--threads");
+                args.push_back(asf::to_string(std::max<size_t>(threads, 1)));
+            }
+
+            // The project renders an unlimited number of passes in Time Limit mode.
+            if (m_timeLimit > 0.0)
+            {
+                args.push_back("--time-limit");
+                args.push_back(asf::to_string(m_timeLimit));
+            }
+
+            worker.m_process.reset(new RenderProcess());
+            if (!worker.m_process->start(executable.string(), args, m_processNiceness))
+            {
+                m_renderWorkers.clear();
+                removeRenderProcessFiles();
+                return false;
+            }
+
+            m_renderWorkers.push_back(worker);
+        }
+
+        if (workerCount > 1)
+        {
+            RENDERER_LOG_INFO(
+                "appleseedMaya: rendering the frame in %u separate processes on %u NUMA nodes.",
+                static_cast<unsigned int>(workerCount),
+                static_cast<unsigned int>(std::max<size_t>(nodeCpuLists.size(), 1)));
+        }
+        else
+            RENDERER_LOG_INFO("appleseedMaya: rendering in a separate process.");
+
+        return true;
+    }
+
+    // Render time limit in seconds, 0 if not limited.
+    double timeLimit() const
+    {
+        return m_timeLimit;
+    }
+
+    void setRenderingThreads(const int threads)
+    {
+        m_project->configurations().get_by_name("final")->get_parameters()
+            .insert_path("rendering_threads", threads);
+    }
+
+    // Write the project, including the geometry, so that a render process can read it.
+    bool writeRenderProcessProject(const bfs::path& projectPath)
+    {
+        const bfs::path projectDir = projectPath.parent_path();
+        m_project->set_path(projectPath.string().c_str());
+        m_project->search_paths().set_root_path(projectDir.string().c_str());
+
+        if (!asr::ProjectFileWriter::write(
+                *m_project,
+                projectPath.string().c_str(),
+                asr::ProjectFileWriter::OmitHandlingAssetFiles))
+        {
+            RENDERER_LOG_ERROR(
+                "appleseedMaya: could not write render process project %s",
+                projectPath.string().c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    void renderWorkersFunc()
+    {
+        collectRenderWorkerTiles();
+        IdleJobQueue::pushJob(&AppleseedSession::endSession);
+    }
+
+    // Forward the tiles of the render processes to the render view and the frame
+    // until all the processes exit. Returns true if all of them succeeded.
+    bool collectRenderWorkerTiles()
+    {
+        SharedTileBuffer::Tile tile;
+        bool abortRequested = false;
+        int abortWait = 0;
+
+        while (true)
+        {
+            if (!abortRequested &&
+                m_rendererController.get_status() == asr::IRendererController::AbortRendering)
+            {
+                for (size_t i = 0, e = m_renderWorkers.size(); i < e; ++i)
+                    m_renderWorkers[i].m_tileBuffer->requestAbort();
+
+                abortRequested = true;
+            }
+
+            size_t runningCount = 0;
+            size_t tileCount = 0;
+
+            for (size_t i = 0, e = m_renderWorkers.size(); i < e; ++i)
+            {
+                RenderWorker& worker = m_renderWorkers[i];
+
+                // Check before reading, so that the last tiles are not lost.
+                if (worker.m_process->isRunning())
+                    ++runningCount;
+
+                while (worker.m_tileBuffer->readTile(tile))
+                {
+                    if (clipTile(worker.m_window, tile))
+                        receiveTile(tile);
+
+                    ++tileCount;
+                }
+            }
+
+            if (runningCount == 0)
+                break;
+
+            // Kill the render processes if they ignore the abort request.
+            if (abortRequested && ++abortWait == 500)
+            {
+                for (size_t i = 0, e = m_renderWorkers.size(); i < e; ++i)
+                    m_renderWorkers[i].m_process->terminate();
+            }
+
+            if (tileCount == 0)
+                boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        }
+
+        bool succeeded = !abortRequested;
+
+        for (size_t i = 0, e = m_renderWorkers.size(); i < e; ++i)
+        {
+            const RenderProcess& process = *m_renderWorkers[i].m_process;
+
+            if (!process.succeeded())
+            {
+                succeeded = false;
+
+                if (process.crashed() && !abortRequested)
+                    RENDERER_LOG_ERROR("appleseedMaya: render process crashed.");
+                else if (!abortRequested)
+                    RENDERER_LOG_ERROR("appleseedMaya: render process failed.");
+            }
+        }
+
+        m_renderWorkers.clear();
+        removeRenderProcessFiles();
+        return succeeded;
+    }
+
+    // Restrict a tile to the window rendered by a process. The pixels
+    // of the tile outside of the process crop window are not rendered.
+    static bool clipTile(const asf::AABB2u& window, SharedTileBuffer::Tile& tile)
+    {
+        const size_t xmin = std::max(tile.m_x, window.min.x);
+        const size_t ymin = std::max(tile.m_y, window.min.y);
+        const size_t xmax = std::min(tile.m_x + tile.m_width, window.max.x + 1);
+        const size_t ymax = std::min(tile.m_y + tile.m_height, window.max.y + 1);
+
+        if (xmin >= xmax || ymin >= ymax)
+            return false;
+
+        const size_t width = xmax - xmin;
+        const size_t height = ymax - ymin;
+
+        if (width == tile.m_width && height == tile.m_height)
+            return true;
+
+        if (tile.m_kind == SharedTileBuffer::TilePixels)
+        {
+            // Compact the rows in place, destination rows never overlap later source rows.
+            for (size_t y = 0; y < height; ++y)
+            {
+                const float* src = &tile.m_pixels[4 * ((ymin - tile.m_y + y) * tile.m_width + xmin - tile.m_x)];
+                std::copy(src, src + 4 * width, &tile.m_pixels[4 * y * width]);
+            }
+
+            tile.m_pixels.resize(4 * width * height);
+        }
+
+        tile.m_x = xmin;
+        tile.m_y = ymin;
+        tile.m_width = width;
+        tile.m_height = height;
+        return true;
+    }
+
+    void receiveTile(const SharedTileBuffer::Tile& tile)
+    {
+        if (tile.m_kind == SharedTileBuffer::TileHighlight)
+        {
+            if (m_tileCallbackFactory.get())
+                m_tileCallbackFactory->highlightTile(tile.m_x, tile.m_y, tile.m_width, tile.m_height);
+
+            return;
+        }
+
+        m_rendererController.on_tile_rendered(tile.m_width * tile.m_height);
+
+        if (m_tileCallbackFactory.get())
+        {
+            m_tileCallbackFactory->writeTile(
+                tile.m_x,
+                tile.m_y,
+                tile.m_width,
+                tile.m_height,
+                &tile.m_pixels[0]);
+        }
+
+        // Stitch the tile into the frame.
+        asf::Image& image = m_project->get_frame()->image();
+        const float* p = &tile.m_pixels[0];
+
+        for (size_t y = 0; y < tile.m_height; ++y)
+        {
+            for (size_t x = 0; x < tile.m_width; ++x, p += 4)
+                image.set_pixel(tile.m_x + x, tile.m_y + y, asf::Color4f(p[0], p[1], p[2], p[3]));
+        }
+    }
+
+    void removeRenderProcessFiles()
+    {
+        if (!m_renderProcessDir.empty())
+        {
+            boost::system::error_code ec;
+            bfs::remove_all(m_renderProcessDir, ec);
+            m_renderProcessDir.clear();
+        }
+    }
+#endif
+
+    void abortRender()
+    {
+        m_rendererController.set_status(asr::IRendererController::AbortRendering);
+        if (m_renderThread.joinable())
+            m_renderThread.join();
+    }
+
+    bool writeProject() const
+    {
+        return writeProject(m_fileName.asChar());
+    }
+
+    bool writeProject(const char *filename) const
+    {
+        return asr::ProjectFileWriter::write(
+            *m_project,
+            filename,
+            asr::ProjectFileWriter::OmitHandlingAssetFiles |
+            asr::ProjectFileWriter::OmitWritingGeometryFiles);
+    }
+
+    // Write the main image and the AOVs. OpenEXR images are written
+    // into a single multi-layer file, mostly while rendering.
+    void writeImages(const char *filename)
+    {
+        writeImages(filename, m_asyncExrWriter);
+    }
+
+    // Same as above, OpenEXR images written after rendering are written by
+    // asyncExrWriter, which can outlive the session.
+    void writeImages(const char *filename, AsyncExrWriter& asyncExrWriter)
+    {
+        const asr::Frame* frame = m_project->get_frame();
+
+        if (m_exrWriter.isOpen())
+        {
+            m_exrWriter.close(*frame);
+            return;
+        }
+
+        // Copy the frame and compress it in the background, while the next frame renders.
+        if (asf::ends_with(filename, ".exr"))
+        {
+            asyncExrWriter.write(filename, *frame, m_exrOptions);
+            return;
+        }
+
+        frame->write_main_image(filename);
+
+        if (frame->aov_images().size() != 0)
+            frame->write_aov_images(filename);
+    }
+
+    asr::Assembly *mainAssembly()
+    {
+        asr::Scene *scene = m_project->get_scene();
+        return scene->assemblies().get_by_name("assembly");
+    }
+
+    void checkUserAborted() const
+    {
+        if (m_computation)
+            m_computation->thowIfInterruptRequested();
+    }
+
+    typedef boost::unordered_map<DagInstanceKey, DagNodeExporterPtr, DagInstanceKeyHash>        DagExporterMap;
+    typedef boost::unordered_map<MObjectHandle, ShadingEngineExporterPtr, MObjectHandleHash>    ShadingEngineExporterMap;
+    typedef boost::unordered_map<MObjectHandle, ShadingNetworkExporterPtr, MObjectHandleHash>   ShadingNetworkExporterMap;
+    typedef boost::array<ShadingNetworkExporterMap, NumShadingNetworkContexts>                  ShadingNetworkExporterMapArray;
+
+    // Declared first so the interned entity names outlive the exporters.
+    EntityNames::Scope                                      m_entityNamesScope;
+
+    AppleseedSession::SessionMode                           m_sessionMode;
+    AppleseedSession::Options                               m_options;
+    ComputationPtr                                          m_computation;
+    ServicesImpl                                            m_services;
+    MTime                                                   m_savedTime;
+
+    asf::auto_release_ptr<renderer::Project>                m_project;
+
+    MString                                                 m_fileName;
+    bfs::path                                               m_projectPath;
+
+    // Incremental updates (batch sequences).
+    typedef boost::unordered_map<DagInstanceKey, MurmurHash, DagInstanceKeyHash>                DagHashMap;
+
+    bool                                                    m_incremental;
+    MurmurHash                                              m_sceneStructureHash;
+    MurmurHash                                              m_shadingHash;
+    DagHashMap                                              m_dagHashes;
+
+    DagExporterMap                                          m_dagExporters;
+    ShadingEngineExporterMap                                m_shadingEngineExporters;
+    ShadingNetworkExporterMapArray                          m_shadingNetworkExporters;
+
+    boost::scoped_ptr<asr::MasterRenderer>                  m_renderer;
+    RendererController                                      m_rendererController;
+    asf::auto_release_ptr<RenderViewTileCallbackFactory>    m_tileCallbackFactory;
+    std::vector<std::string>                                m_aovModels;    // Enabled AOVs, read from the render globals.
+    ExrWriteOptions                                         m_exrOptions;
+    TiledExrWriter                                          m_exrWriter;
+    AsyncExrWriter                                          m_asyncExrWriter;
+    asf::auto_release_ptr<TiledExrWriterTileCallbackFactory> m_exrTileCallbackFactory;
+    std::vector<asf::AABB2u>                                m_renderWindows;
+
+    boost::thread                                           m_renderThread;
+
+    // Render processes.
+    int                                                     m_frameWorkers;
+    int                                                     m_processNiceness;
+
+    // Checkpoints (batch renders).
+    bool                                                    m_checkpointEnabled;
+    int                                                     m_checkpointInterval;
+    bool                                                    m_resumeCheckpoint;
+    size_t                                                  m_checkpointPasses;     // Pass count of a resumed render, 0 if not resuming.
+
+    // Final render time limit in seconds, 0 if not limited.
+    double                                                  m_timeLimit;
+    FrameCheckpoint                                         m_checkpoint;
+    asf::auto_release_ptr<FrameCheckpointTileCallbackFactory> m_checkpointTileCallbackFactory;
+
+#ifdef APPLESEED_MAYA_WITH_RENDER_PROCESS
+    struct RenderWorker
+    {
+        boost::shared_ptr<SharedTileBuffer>                 m_tileBuffer;
+        boost::shared_ptr<RenderProcess>                    m_process;
+        asf::AABB2u                                         m_window;   // Pixels rendered by the process.
+    };
+
+    typedef std::vector<RenderWorker>                       RenderWorkerVector;
+
+    bfs::path                                               m_renderProcessDir;
+    RenderWorkerVector                                      m_renderWorkers;
+#endif
+};
+
+// Globals.
+MTime                           g_savedTime;     // Saved time.
+boost::scoped_ptr<SessionImpl>  g_globalSession; // Global session.
+
+} // unnamed
+
+namespace AppleseedSession
+{
+
+MStatus initialize(const MString& pluginPath)
+{
+    g_pluginPath = pluginPath.asChar();
+    return MS::kSuccess;
+}
+
+MStatus uninitialize()
+{
+    g_globalSession.reset();
+    return MS::kSuccess;
+}
+
+namespace
+{
+
+void beginSession(
+    AppleseedSession::SessionMode       mode,
+    const AppleseedSession::Options&    options,
+    ComputationPtr                      computation)
+{
+    g_globalSession.reset(new SessionImpl(mode, options, computation));
+}
+
+void beginSession(
+    const char*                         fileName,
+    const AppleseedSession::Options&    options,
     ComputationPtr                      computation)
 {
     g_globalSession.reset(new SessionImpl(fileName, options, computation));
@@ -896,23 +2032,31 @@ MString batchRenderFileName(
         status);
 }
 
+const char* batchRenderColorspace(const MString& outputFilename)
+{
+    if (asf::ends_with(outputFilename.asChar(), ".png"))
+        return "srgb";
+
+    return "linear_rgb";
+}
+
+// OpenEXR images are written by exrWriter in the background, while the next
+// frame is exported and rendered by a new session.
 MStatus batchRenderFrame(
-    Options        options,
-    const MString& outputFilename)
+    Options         options,
+    const MString&  outputFilename,
+    AsyncExrWriter& exrWriter)
 {
     ScopedEndSession session;
 
     try
     {
-        if (asf::ends_with(outputFilename.asChar(), ".png"))
-            options.m_colorspace = "srgb";
-        else
-            options.m_colorspace = "linear_rgb";
+        options.m_colorspace = batchRenderColorspace(outputFilename);
 
         beginSession(FinalRenderSession, options, ComputationPtr());
         g_globalSession->exportProject();
-        g_globalSession->batchRender();
-        g_globalSession->writeMainImage(outputFilename.asChar());
+        g_globalSession->batchRender(outputFilename);
+        g_globalSession->writeImages(outputFilename.asChar(), exrWriter);
     }
     catch (const AppleseedMayaException&)
     {
@@ -930,6 +2074,474 @@ MStatus batchRenderFrame(
     return MS::kSuccess;
 }
 
+struct BatchFrame
+{
+    double  m_frame;
+    MString m_fileName;
+};
+
+//
+// Incremental batch rendering.
+//
+//  The project and the master renderer are kept alive across frames.
+//  For each frame, only the dag nodes whose transform, geometry or animated
+//  attributes changed are exported again. If dag nodes are added, removed,
+//  shown or hidden, or if shading networks change, the frame is exported
+//  from scratch.
+//
+
+MStatus batchRenderIncremental(
+    Options                         options,
+    const std::vector<BatchFrame>&  frames,
+    const bool                      animated)
+{
+    ScopedEndSession session;
+
+    // All the frames share the same file format.
+    options.m_colorspace = batchRenderColorspace(frames[0].m_fileName);
+
+    for (size_t i = 0, e = frames.size(); i < e; ++i)
+    {
+        if (animated)
+            MGlobal::viewFrame(frames[i].m_frame);
+
+        RENDERER_LOG_DEBUG(
+            "Batch render: rendering frame %f, filename = %s",
+            frames[i].m_frame,
+            frames[i].m_fileName.asChar());
+
+        try
+        {
+            if (g_globalSession.get() == 0 || !g_globalSession->updateAnimatedEntities())
+            {
+                beginSession(FinalRenderSession, options, ComputationPtr());
+                g_globalSession->enableIncrementalUpdates();
+                g_globalSession->exportProject();
+            }
+
+            g_globalSession->batchRender(frames[i].m_fileName);
+            g_globalSession->writeImages(frames[i].m_fileName.asChar());
+        }
+        catch (const AppleseedMayaException&)
+        {
+            RENDERER_LOG_ERROR("Batch render: could not render frame %f", frames[i].m_frame);
+            g_globalSession.reset();
+        }
+        catch (const std::exception&)
+        {
+            RENDERER_LOG_ERROR("Batch render: could not render frame %f", frames[i].m_frame);
+            g_globalSession.reset();
+        }
+    }
+
+    return MS::kSuccess;
+}
+
+typedef boost::shared_ptr<SessionImpl> SessionImplPtr;
+
+struct RenderBatchFrame
+{
+    RenderBatchFrame(
+        const SessionImplPtr&   session,
+        const MString&          fileName)
+      : m_session(session)
+      , m_fileName(fileName)
+    {
+    }
+
+    void operator()()
+    {
+        try
+        {
+            m_session->batchRender(m_fileName);
+        }
+        catch (const std::exception& e)
+        {
+            RENDERER_LOG_ERROR("Batch render: %s", e.what());
+        }
+    }
+
+    SessionImplPtr  m_session;
+    MString         m_fileName;
+};
+
+struct WriteBatchFrameImage
+{
+    WriteBatchFrameImage(
+        const SessionImplPtr&   session,
+        const MString&          fileName)
+      : m_session(session)
+      , m_fileName(fileName)
+    {
+    }
+
+    void operator()()
+    {
+        m_session->writeImages(m_fileName.asChar());
+        RENDERER_LOG_DEBUG("Batch render: wrote %s", m_fileName.asChar());
+    }
+
+    SessionImplPtr  m_session;
+    MString         m_fileName;
+};
+
+//
+// Pipelined batch rendering.
+//
+//  Frame N + 1 is exported in the main thread while frame N renders
+//  in a background thread, and the image of frame N is written
+//  in another thread while frame N + 1 renders.
+//  At most three projects are alive at the same time.
+//  Sessions are always destroyed in the main thread.
+//
+
+class BatchRenderPipeline
+  : public NonCopyable
+{
+  public:
+    ~BatchRenderPipeline()
+    {
+        finishRender();
+        finishWrite();
+    }
+
+    void render(const SessionImplPtr& session, const MString& fileName)
+    {
+        finishRender();
+
+        m_renderSession = session;
+        m_renderFileName = fileName;
+
+        boost::thread thread(RenderBatchFrame(session, fileName));
+        m_renderThread.swap(thread);
+    }
+
+    // Wait until the current frame is rendered and start writing its image.
+    void finishRender()
+    {
+        if (!m_renderSession)
+            return;
+
+        m_renderThread.join();
+
+        // Only one image is written at a time, to bound memory use.
+        finishWrite();
+
+        m_writeSession = m_renderSession;
+        boost::thread thread(WriteBatchFrameImage(m_writeSession, m_renderFileName));
+        m_writeThread.swap(thread);
+
+        m_renderSession.reset();
+    }
+
+  private:
+    void finishWrite()
+    {
+        if (m_writeThread.joinable())
+            m_writeThread.join();
+
+        m_writeSession.reset();
+    }
+
+    SessionImplPtr  m_renderSession;
+    MString         m_renderFileName;
+    boost::thread   m_renderThread;
+
+    SessionImplPtr  m_writeSession;
+    boost::thread   m_writeThread;
+};
+
+MStatus batchRenderPipelined(
+    Options                         options,
+    const std::vector<BatchFrame>&  frames,
+    const bool                      animated)
+{
+    BatchRenderPipeline pipeline;
+
+    for (size_t i = 0, e = frames.size(); i < e; ++i)
+    {
+        if (animated)
+            MGlobal::viewFrame(frames[i].m_frame);
+
+        RENDERER_LOG_DEBUG(
+            "Batch render: exporting frame %f, filename = %s",
+            frames[i].m_frame,
+            frames[i].m_fileName.asChar());
+
+        SessionImplPtr session;
+
+        try
+        {
+            options.m_colorspace = batchRenderColorspace(frames[i].m_fileName);
+            session.reset(new SessionImpl(FinalRenderSession, options, ComputationPtr()));
+            session->exportProject();
+        }
+        catch (const AppleseedMayaException&)
+        {
+            RENDERER_LOG_ERROR("Batch render: could not export frame %f", frames[i].m_frame);
+            session.reset();
+        }
+        catch (const std::exception&)
+        {
+            RENDERER_LOG_ERROR("Batch render: could not export frame %f", frames[i].m_frame);
+            session.reset();
+        }
+
+        if (session)
+            pipeline.render(session, frames[i].m_fileName);
+    }
+
+    return MS::kSuccess;
+}
+
+#ifdef APPLESEED_MAYA_WITH_RENDER_PROCESS
+
+//
+// Local render processes.
+//
+//  Each frame is exported to its own project in a temporary directory and
+//  rendered by an appleseedMayaRender process. Up to processCount processes
+//  run at the same time; frames are rendered as soon as they are exported.
+//
+
+class BatchRenderProcessQueue
+  : public NonCopyable
+{
+  public:
+    BatchRenderProcessQueue(
+        const bfs::path&    executable,
+        const bfs::path&    schema,
+        const size_t        processCount,
+        const size_t        frameCount)
+      : m_executable(executable)
+      , m_schema(schema)
+      , m_processCount(processCount)
+      , m_frameCount(frameCount)
+      , m_finishedCount(0)
+      , m_failedCount(0)
+    {
+    }
+
+    ~BatchRenderProcessQueue()
+    {
+        // Terminate processes still running.
+        m_running.clear();
+    }
+
+    void push(
+        const bfs::path&    projectPath,
+        const BatchFrame&   frame,
+        const double        timeLimit)
+    {
+        PendingFrame pending;
+        pending.m_projectPath = projectPath;
+        pending.m_frame = frame;
+        pending.m_timeLimit = timeLimit;
+        m_pending.push_back(pending);
+
+        update();
+    }
+
+    // Start pending frames and collect finished ones.
+    void update()
+    {
+        for (size_t i = 0; i < m_running.size();)
+        {
+            if (m_running[i].m_process->isRunning())
+            {
+                ++i;
+                continue;
+            }
+
+            frameFinished(m_running[i]);
+            m_running.erase(m_running.begin() + i);
+        }
+
+        while (!m_pending.empty() && m_running.size() < m_processCount)
+        {
+            RunningFrame running;
+            running.m_frame = m_pending.front().m_frame;
+            running.m_process.reset(new RenderProcess());
+
+            std::vector<std::string> args;
+            args.push_back(m_pending.front().m_projectPath.string());
+            args.push_back("--output");
+            args.push_back(running.m_frame.m_fileName.asChar());
+            args.push_back("--schema");
+            args.push_back(m_schema.string());
+
+            if (m_pending.front().m_timeLimit > 0.0)
+            {
+                args.push_back("--time-limit");
+                args.push_back(asf::to_string(m_pending.front().m_timeLimit));
+            }
+
+            m_pending.pop_front();
+
+            if (running.m_process->start(m_executable.string(), args))
+            {
+                RENDERER_LOG_DEBUG("Batch render: started frame %f", running.m_frame.m_frame);
+                m_running.push_back(running);
+            }
+            else
+            {
+                ++m_finishedCount;
+                ++m_failedCount;
+            }
+        }
+    }
+
+    void wait()
+    {
+        while (!m_pending.empty() || !m_running.empty())
+        {
+            update();
+            boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+        }
+    }
+
+    size_t failedCount() const
+    {
+        return m_failedCount;
+    }
+
+  private:
+    struct PendingFrame
+    {
+        bfs::path   m_projectPath;
+        BatchFrame  m_frame;
+        double      m_timeLimit;
+    };
+
+    struct RunningFrame
+    {
+        BatchFrame                          m_frame;
+        boost::shared_ptr<RenderProcess>    m_process;
+    };
+
+    void frameFinished(const RunningFrame& running)
+    {
+        ++m_finishedCount;
+
+        if (running.m_process->succeeded())
+        {
+            RENDERER_LOG_INFO(
+                "Batch render: rendered frame %f (%u of %u), filename = %s",
+                running.m_frame.m_frame,
+                static_cast<unsigned int>(m_finishedCount),
+                static_cast<unsigned int>(m_frameCount),
+                running.m_frame.m_fileName.asChar());
+        }
+        else
+        {
+            ++m_failedCount;
+            RENDERER_LOG_ERROR(
+                "Batch render: render process failed for frame %f (%u of %u)",
+                running.m_frame.m_frame,
+                static_cast<unsigned int>(m_finishedCount),
+                static_cast<unsigned int>(m_frameCount));
+        }
+    }
+
+    const bfs::path             m_executable;
+    const bfs::path             m_schema;
+    const size_t                m_processCount;
+    const size_t                m_frameCount;
+    size_t                      m_finishedCount;
+    size_t                      m_failedCount;
+    std::deque<PendingFrame>    m_pending;
+    std::vector<RunningFrame>   m_running;
+};
+
+MStatus batchRenderProcesses(
+    Options                         options,
+    const std::vector<BatchFrame>&  frames,
+    const bool                      animated,
+    const MObject&                  globalsNode)
+{
+    const bfs::path executable = renderProcessExecutable();
+    if (executable.empty())
+        return MS::kFailure;
+
+    const bfs::path schema = renderProcessSchema();
+    if (schema.empty())
+        return MS::kFailure;
+
+    const bfs::path dir = createRenderProcessDirectory();
+    if (dir.empty())
+        return MS::kFailure;
+
+    const size_t cores = std::max(boost::thread::hardware_concurrency(), 1u);
+
+    int processCount = 0;
+    AttributeUtils::get(globalsNode, "batchProcesses", processCount);
+    if (processCount <= 0)
+        processCount = static_cast<int>(std::max<size_t>(cores / 8, 1));
+    processCount = std::min(processCount, static_cast<int>(frames.size()));
+
+    int threads = 0;
+    AttributeUtils::get(globalsNode, "batchProcessThreads", threads);
+    if (threads <= 0)
+        threads = static_cast<int>(std::max<size_t>(cores / processCount, 1));
+
+    RENDERER_LOG_INFO(
+        "Batch render: rendering %u frames with %d processes, %d threads each.",
+        static_cast<unsigned int>(frames.size()),
+        processCount,
+        threads);
+
+    BatchRenderProcessQueue queue(executable, schema, processCount, frames.size());
+
+    for (size_t i = 0, e = frames.size(); i < e; ++i)
+    {
+        if (animated)
+            MGlobal::viewFrame(frames[i].m_frame);
+
+        RENDERER_LOG_DEBUG(
+            "Batch render: exporting frame %f, filename = %s",
+            frames[i].m_frame,
+            frames[i].m_fileName.asChar());
+
+        const bfs::path projectPath =
+            dir / asf::get_numbered_string("frame_####", i) / "project.appleseed";
+
+        try
+        {
+            ScopedEndSession session;
+
+            boost::system::error_code ec;
+            bfs::create_directories(projectPath.parent_path(), ec);
+
+            options.m_colorspace = batchRenderColorspace(frames[i].m_fileName);
+            beginSession(FinalRenderSession, options, ComputationPtr());
+            g_globalSession->exportProject();
+            g_globalSession->setRenderingThreads(threads);
+
+            if (g_globalSession->writeRenderProcessProject(projectPath))
+                queue.push(projectPath, frames[i], g_globalSession->timeLimit());
+        }
+        catch (const AppleseedMayaException&)
+        {
+            RENDERER_LOG_ERROR("Batch render: could not export frame %f", frames[i].m_frame);
+        }
+        catch (const std::exception&)
+        {
+            RENDERER_LOG_ERROR("Batch render: could not export frame %f", frames[i].m_frame);
+        }
+
+        queue.update();
+    }
+
+    queue.wait();
+
+    boost::system::error_code ec;
+    bfs::remove_all(dir, ec);
+
+    return queue.failedCount() == 0 ? MS::kSuccess : MS::kFailure;
+}
+
+#endif
+
 } // unnamed.
 
 MStatus batchRender(Options options)
@@ -986,7 +2598,10 @@ MStatus batchRender(Options options)
     MCommonRenderSettingsData renderSettings;
     MRenderUtil::getCommonRenderSettings(renderSettings);
 
-    if (renderSettings.isAnimated())
+    std::vector<BatchFrame> frames;
+    const bool animated = renderSettings.isAnimated();
+
+    if (animated)
     {
         const double frameStart = renderSettings.frameStart.value();
         const double frameEnd = renderSettings.frameEnd.value();
@@ -994,8 +2609,9 @@ MStatus batchRender(Options options)
 
         for (double frame = frameStart; frame <= frameEnd; frame += frameBy)
         {
-            MGlobal::viewFrame(frame);
-            MString outputFileName = batchRenderFileName(
+            BatchFrame batchFrame;
+            batchFrame.m_frame = frame;
+            batchFrame.m_fileName = batchRenderFileName(
                 renderSettings,
                 frame,
                 sceneName,
@@ -1003,27 +2619,63 @@ MStatus batchRender(Options options)
                 fileFormat,
                 renderLayer,
                 &status);
-
-            RENDERER_LOG_DEBUG("Batch render: rendering frame %f, filename = %s", frame, outputFileName.asChar());
-            status = batchRenderFrame(options, outputFileName);
-            RENDERER_LOG_DEBUG("Status = %s", status.errorString().asChar());
-            RENDERER_LOG_DEBUG("=================================");
+            frames.push_back(batchFrame);
         }
     }
     else
     {
-        const double frame = MAnimControl::currentTime().value();
-        MString outputFileName = batchRenderFileName(
+        BatchFrame batchFrame;
+        batchFrame.m_frame = MAnimControl::currentTime().value();
+        batchFrame.m_fileName = batchRenderFileName(
             renderSettings,
-            frame,
+            batchFrame.m_frame,
             sceneName,
             cameraName,
             fileFormat,
             renderLayer,
             &status);
+        frames.push_back(batchFrame);
+    }
+
+    int batchMode = 0;
+    MObject appleseedRenderGlobalsNode;
+    if (getDependencyNodeByName("appleseedRenderGlobals", appleseedRenderGlobalsNode))
+        AttributeUtils::get(appleseedRenderGlobalsNode, "batchMode", batchMode);
+
+    if (batchMode == 1 && frames.size() > 1)
+    {
+        RENDERER_LOG_DEBUG("Batch render: pipelined mode");
+        return batchRenderPipelined(options, frames, animated);
+    }
+
+    if (batchMode == 2 && frames.size() > 1)
+    {
+        RENDERER_LOG_DEBUG("Batch render: incremental mode");
+        return batchRenderIncremental(options, frames, animated);
+    }
+
+    if (batchMode == 3)
+    {
+#ifdef APPLESEED_MAYA_WITH_RENDER_PROCESS
+        RENDERER_LOG_DEBUG("Batch render: local processes mode");
+        return batchRenderProcesses(options, frames, animated, appleseedRenderGlobalsNode);
+#else
+        RENDERER_LOG_WARNING("Batch render: local processes are not supported on this platform.");
+#endif
+    }
 
-        RENDERER_LOG_DEBUG("Batch render: rendering single frame, filename = %s", outputFileName.asChar());
-        status = batchRenderFrame(options, outputFileName);
+    AsyncExrWriter exrWriter;
+
+    for (size_t i = 0, e = frames.size(); i < e; ++i)
+    {
+        if (animated)
+            MGlobal::viewFrame(frames[i].m_frame);
+
+        RENDERER_LOG_DEBUG(
+            "Batch render: rendering frame %f, filename = %s",
+            frames[i].m_frame,
+            frames[i].m_fileName.asChar());
+        status = batchRenderFrame(options, frames[i].m_fileName, exrWriter);
         RENDERER_LOG_DEBUG("Status = %s", status.errorString().asChar());
         RENDERER_LOG_DEBUG("=================================");
     }
@@ -1044,6 +2696,26 @@ void endSession()
     }
 }
 
+void pauseRender(const bool pause)
+{
+    if (g_globalSession.get() == 0)
+        return;
+
+    if (pause)
+        g_globalSession->m_rendererController.pause_rendering();
+    else
+        g_globalSession->m_rendererController.resume_rendering();
+}
+
+bool renderProgress(RenderProgress& progress)
+{
+    if (g_globalSession.get() == 0 || g_globalSession->m_sessionMode == ExportSession)
+        return false;
+
+    progress = g_globalSession->m_rendererController.get_progress();
+    return true;
+}
+
 SessionMode sessionMode()
 {
     if (g_globalSession.get() == 0)
@@ -43,6 +43,9 @@
 #include "appleseedmaya/exporters/shadingnetworkexporterfwd.h"
 #include "appleseedmaya/utils.h"
 
+// Forward declarations.
+struct RenderProgress;
+
 struct MotionBlurTimes
 {
     std::set<float> m_cameraTimes;
@@ -139,6 +142,12 @@ MStatus batchRender(Options options);
 
 void endSession();
 
+// Pause or resume the current render.
+void pauseRender(const bool pause);
+
+// Get the progress of the current render. Returns false if not rendering.
+bool renderProgress(RenderProgress& progress);
+
 SessionMode sessionMode();
 
 const Options& options();
@@ -29,12 +29,75 @@
 // Interface header.
 #include "appleseedmaya/attributeutils.h"
 
+// Standard headers.
+#include <map>
+#include <utility>
+
+// Boost headers.
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
 // Maya headers.
 #include <maya/MFnMatrixData.h>
+#include <maya/MTypeId.h>
+
+// appleseed.maya headers.
+#include "appleseedmaya/utils.h"
 
 namespace
 {
 
+//
+// Attribute cache.
+//
+//  Maps a node type id and an attribute name to the attribute.
+//
+
+struct AttributeKeyLess
+{
+    bool operator()(
+        const std::pair<unsigned int, MString>& a,
+        const std::pair<unsigned int, MString>& b) const
+    {
+        if (a.first != b.first)
+            return a.first < b.first;
+
+        return MStringCompareLess()(a.second, b.second);
+    }
+};
+
+typedef std::map<
+    std::pair<unsigned int, MString>,
+    MObject,
+    AttributeKeyLess
+    > AttributeCache;
+
+AttributeCache  gAttributeCache;
+boost::mutex    gAttributeCacheMutex;
+
+MObject findAttribute(const MFnDependencyNode& depNodeFn, const MString& attrName)
+{
+    const std::pair<unsigned int, MString> key(depNodeFn.typeId().id(), attrName);
+
+    boost::lock_guard<boost::mutex> lock(gAttributeCacheMutex);
+
+    AttributeCache::const_iterator it = gAttributeCache.find(key);
+    if (it != gAttributeCache.end())
+        return it->second;
+
+    MStatus status;
+    MObject attr = depNodeFn.attribute(attrName, &status);
+    if (!status || attr.isNull())
+        return MObject::kNullObj;
+
+    // Dynamic attributes only exist on the node they were added to.
+    MFnAttribute attrFn(attr);
+    if (!attrFn.isDynamic() || attrFn.isExtension())
+        gAttributeCache[key] = attr;
+
+    return attr;
+}
+
 template<class T>
 MStatus get3(const MPlug& plug, T& x, T& y, T& z)
 {
@@ -56,6 +119,29 @@ MStatus get3(const MPlug& plug, T& x, T& y, T& z)
 namespace AttributeUtils
 {
 
+MPlug findPlug(const MFnDependencyNode& depNodeFn, const MString& attrName, MStatus* status)
+{
+    MObject attr = findAttribute(depNodeFn, attrName);
+    if (attr.isNull())
+    {
+        if (status)
+            *status = MS::kInvalidParameter;
+
+        return MPlug();
+    }
+
+    if (status)
+        *status = MS::kSuccess;
+
+    return MPlug(depNodeFn.object(), attr);
+}
+
+void clearAttributeCache()
+{
+    boost::lock_guard<boost::mutex> lock(gAttributeCacheMutex);
+    gAttributeCache.clear();
+}
+
 MStatus get(const MPlug& plug, MAngle& value)
 {
     return plug.getValue(value);
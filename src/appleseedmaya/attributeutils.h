@@ -58,11 +58,20 @@ MStatus get(const MPlug& plug, MPoint& value);
 MStatus get(const MPlug& plug, MVector& value);
 MStatus get(const MPlug& plug, MMatrix& value);
 
+// Return the plug of a node for the attribute named attrName.
+// Static and extension attributes are resolved once per node type
+// and cached; dynamic attributes are looked up every time.
+MPlug findPlug(const MFnDependencyNode& depNodeFn, const MString& attrName, MStatus* status = 0);
+
+// Forget the cached attributes.
+// Must be called when node types are registered or deregistered.
+void clearAttributeCache();
+
 template<class T>
 MStatus get(const MFnDependencyNode& depNodeFn, const MString& attrName, T& value)
 {
     MStatus status;
-    MPlug plug = depNodeFn.findPlug(attrName, &status);
+    MPlug plug = findPlug(depNodeFn, attrName, &status);
     if (!status)
         return status;
 
@@ -0,0 +1,193 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "appleseedmaya/displaytransform.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cmath>
+
+// Define APPLESEED_MAYA_NO_SSE2 to build the scalar code path, e.g. to benchmark it.
+#if !defined(APPLESEED_MAYA_NO_SSE2) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define APPLESEED_MAYA_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+const size_t LutSize = 4096;
+
+float srgb(const float x)
+{
+    return x <= 0.0031308f ? 12.92f * x : 1.055f * std::pow(x, 1.0f / 2.4f) - 0.055f;
+}
+
+float rec709(const float x)
+{
+    return x < 0.018f ? 4.5f * x : 1.099f * std::pow(x, 0.45f) - 0.099f;
+}
+
+// John Hable's filmic curve.
+float hable(const float x)
+{
+    const float A = 0.15f, B = 0.50f, C = 0.10f, D = 0.20f, E = 0.02f, F = 0.30f;
+    return ((x * (A * x + C * B) + D * E) / (x * (A * x + B) + D * F)) - E / F;
+}
+
+float filmic(const float x)
+{
+    const float WhitePoint = 11.2f;
+    return srgb(std::min(hable(x) / hable(WhitePoint), 1.0f));
+}
+
+// The filmic lookup table covers [0, inf) through x / (1 + x),
+// the other ones cover [0, 1] linearly.
+float lutInput(const DisplayTransform::Curve curve, const float t)
+{
+    if (curve == DisplayTransform::Filmic)
+        return t < 1.0f ? t / (1.0f - t) : 1.0e+9f;
+
+    return t;
+}
+
+float applyCurve(const DisplayTransform::Curve curve, const float x)
+{
+    switch (curve)
+    {
+      case DisplayTransform::SRGB:
+        return srgb(x);
+
+      case DisplayTransform::Rec709:
+        return rec709(x);
+
+      case DisplayTransform::Filmic:
+        return filmic(x);
+
+      default:
+        return x;
+    }
+}
+
+} // unnamed.
+
+DisplayTransform::DisplayTransform(
+    const Curve     curve,
+    const float     exposure)
+  : m_curve(curve)
+  , m_scale(std::pow(2.0f, exposure))
+{
+    if (m_curve == Linear)
+        return;
+
+    m_lut.resize(LutSize);
+    for (size_t i = 0; i < LutSize; ++i)
+    {
+        const float t = static_cast<float>(i) / (LutSize - 1);
+        m_lut[i] = applyCurve(m_curve, lutInput(m_curve, t));
+    }
+}
+
+bool DisplayTransform::isIdentity() const
+{
+    return m_curve == Linear && m_scale == 1.0f;
+}
+
+void DisplayTransform::apply(const float* src, float* dst, const size_t pixelCount) const
+{
+    const float* lut = m_lut.empty() ? 0 : &m_lut[0];
+    const bool compress = m_curve == Filmic;
+
+#ifdef APPLESEED_MAYA_USE_SSE2
+    // One RGBA pixel per iteration. Alpha goes through the same
+    // operations with a scale of 1, but its lookup is discarded.
+    const __m128 scale = _mm_set_ps(1.0f, m_scale, m_scale, m_scale);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 lutMax = _mm_set1_ps(static_cast<float>(LutSize - 1));
+
+    for (size_t i = 0; i < pixelCount; ++i, src += 4, dst += 4)
+    {
+        const __m128 p = _mm_loadu_ps(src);
+        const float alpha = src[3] > 0.0f ? std::min(src[3], 1.0f) : 0.0f;
+
+        __m128 v = _mm_max_ps(_mm_mul_ps(p, scale), zero);
+
+        if (lut == 0)
+        {
+            _mm_storeu_ps(dst, v);
+            dst[3] = alpha;
+            continue;
+        }
+
+        if (compress)
+            v = _mm_div_ps(v, _mm_add_ps(v, one));
+
+        v = _mm_min_ps(v, one);
+
+        int index[4];
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(index),
+            _mm_cvtps_epi32(_mm_mul_ps(v, lutMax)));
+
+        dst[0] = lut[index[0]];
+        dst[1] = lut[index[1]];
+        dst[2] = lut[index[2]];
+        dst[3] = alpha;
+    }
+#else
+    for (size_t i = 0; i < pixelCount; ++i, src += 4, dst += 4)
+    {
+        const float alpha = src[3] > 0.0f ? std::min(src[3], 1.0f) : 0.0f;
+
+        for (size_t c = 0; c < 3; ++c)
+        {
+            // Written so that NaNs become 0, like _mm_max_ps() does.
+            float v = src[c] * m_scale;
+            v = v > 0.0f ? v : 0.0f;
+
+            if (lut)
+            {
+                if (compress)
+                    v = v / (v + 1.0f);
+
+                // Infinities compress to NaN, clamp them to 1 as well.
+                v = v < 1.0f ? v : 1.0f;
+
+                v = lut[static_cast<size_t>(v * (LutSize - 1) + 0.5f)];
+            }
+
+            dst[c] = v;
+        }
+
+        dst[3] = alpha;
+    }
+#endif
+}
@@ -0,0 +1,73 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_MAYA_DISPLAY_TRANSFORM_H
+#define APPLESEED_MAYA_DISPLAY_TRANSFORM_H
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+//
+// Display transform of the pixels sent to the render view.
+//
+//  Applies an exposure and a view transform to linear RGBA pixels, using a
+//  lookup table and SSE2 when available. Alpha is clamped to [0, 1] but is
+//  otherwise unchanged.
+//
+//  This file does not depend on Maya.
+//
+
+class DisplayTransform
+{
+  public:
+    enum Curve
+    {
+        Linear = 0,     // No transform, pixels are left unchanged.
+        SRGB,
+        Rec709,
+        Filmic          // Filmic tone mapping followed by sRGB.
+    };
+
+    // exposure is in stops.
+    explicit DisplayTransform(
+        const Curve     curve = Linear,
+        const float     exposure = 0.0f);
+
+    bool isIdentity() const;
+
+    // Transform RGBA pixels. src and dst can be the same array.
+    void apply(const float* src, float* dst, const size_t pixelCount) const;
+
+  private:
+    Curve               m_curve;
+    float               m_scale;    // Exposure scale.
+    std::vector<float>  m_lut;
+};
+
+#endif  // !APPLESEED_MAYA_DISPLAY_TRANSFORM_H
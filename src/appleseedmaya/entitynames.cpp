@@ -0,0 +1,127 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "appleseedmaya/entitynames.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstring>
+
+// Boost headers.
+#include "boost/array.hpp"
+#include "boost/functional/hash.hpp"
+#include "boost/unordered_map.hpp"
+
+namespace
+{
+
+const char* SuffixStrings[EntityNames::NumSuffixes] =
+{
+    "",
+    "_assembly",
+    "_assembly_instance",
+    "_instance",
+    "_material"
+};
+
+struct MStringHash
+{
+    size_t operator()(const MString& s) const
+    {
+        const char* p = s.asChar();
+        return boost::hash_range(p, p + s.length());
+    }
+};
+
+struct MStringEqual
+{
+    bool operator()(const MString& a, const MString& b) const
+    {
+        return a.length() == b.length() && strcmp(a.asChar(), b.asChar()) == 0;
+    }
+};
+
+struct SuffixedNames
+{
+    SuffixedNames()
+    {
+        m_built.assign(false);
+    }
+
+    boost::array<MString, EntityNames::NumSuffixes> m_names;
+    boost::array<bool, EntityNames::NumSuffixes>    m_built;
+};
+
+typedef boost::unordered_map<
+    MString,
+    SuffixedNames,
+    MStringHash,
+    MStringEqual
+    > NameTable;
+
+NameTable   gNames;
+int         gScopeCount = 0;
+
+} // unnamed.
+
+namespace EntityNames
+{
+
+const MString& get(const MString& name, const Suffix suffix)
+{
+    assert(gScopeCount > 0);
+    assert(suffix < NumSuffixes);
+
+    // Elements of unordered maps are not moved on rehash,
+    // so the returned references stay valid.
+    SuffixedNames& names = gNames[name];
+
+    if (!names.m_built[suffix])
+    {
+        names.m_names[suffix] = name + MString(SuffixStrings[suffix]);
+        names.m_built[suffix] = true;
+    }
+
+    return names.m_names[suffix];
+}
+
+Scope::Scope()
+{
+    ++gScopeCount;
+}
+
+Scope::~Scope()
+{
+    assert(gScopeCount > 0);
+
+    if (--gScopeCount == 0)
+        gNames.clear();
+}
+
+} // EntityNames.
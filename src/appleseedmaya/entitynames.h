@@ -0,0 +1,77 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_MAYA_ENTITY_NAMES_H
+#define APPLESEED_MAYA_ENTITY_NAMES_H
+
+// Maya headers.
+#include <maya/MString.h>
+
+// appleseed.maya headers.
+#include "appleseedmaya/utils.h"
+
+//
+// Session wide table of interned appleseed entity names.
+//
+//  Names and their suffixed variants are built once and shared by all the
+//  exporters that use them. The table is only used from the main thread.
+//
+
+namespace EntityNames
+{
+
+enum Suffix
+{
+    NoSuffix = 0,
+    AssemblySuffix,             // _assembly
+    AssemblyInstanceSuffix,     // _assembly_instance
+    InstanceSuffix,             // _instance
+    MaterialSuffix,             // _material
+    NumSuffixes
+};
+
+// Return the interned name followed by suffix.
+// The reference stays valid until the last scope is destroyed.
+const MString& get(const MString& name, const Suffix suffix = NoSuffix);
+
+//
+// Keeps the interned names alive. The table is cleared when
+// the last scope is destroyed.
+//
+
+class Scope
+  : public NonCopyable
+{
+  public:
+    Scope();
+    ~Scope();
+};
+
+} // EntityNames.
+
+#endif  // !APPLESEED_MAYA_ENTITY_NAMES_H
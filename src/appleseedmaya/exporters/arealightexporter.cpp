@@ -125,7 +125,7 @@ void AreaLightExporter::createEntities(const AppleseedSession::Options& options)
     m = m * asf::Matrix4d::make_rotation_x(asf::deg_to_rad(-90.0));
     asf::Transformd xform(m, asf::inverse(m));
 
-    const MString objectInstanceName = appleseedName() + MString("_instance");
+    const MString& objectInstanceName = appleseedName(EntityNames::InstanceSuffix);
     params.clear();
     visibilityAttributesToParams(params);
     m_objectInstance.reset(
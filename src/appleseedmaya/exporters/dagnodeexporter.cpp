@@ -30,7 +30,10 @@
 #include "appleseedmaya/exporters/dagnodeexporter.h"
 
 // Maya headers.
+#include <maya/MAnimControl.h>
+#include <maya/MAnimUtil.h>
 #include <maya/MFnDagNode.h>
+#include <maya/MFnDependencyNode.h>
 
 // appleseed.renderer headers.
 #include "renderer/api/project.h"
@@ -38,6 +41,7 @@
 
 // appleseed.maya headers.
 #include "appleseedmaya/attributeutils.h"
+#include "appleseedmaya/murmurhash.h"
 
 namespace asf = foundation;
 namespace asr = renderer;
@@ -52,6 +56,10 @@ DagNodeExporter::DagNodeExporter(
   , m_scene(*project.get_scene())
   , m_mainAssembly(*m_scene.assemblies().get_by_name("assembly"))
 {
+    for(size_t i = 0; i < EntityNames::NumSuffixes; ++i)
+        m_names[i] = 0;
+
+    m_names[EntityNames::NoSuffix] = &EntityNames::get(path.fullPathName());
 }
 
 DagNodeExporter::~DagNodeExporter()
@@ -108,9 +116,31 @@ void DagNodeExporter::exportShapeMotionStep(float time)
 {
 }
 
-MString DagNodeExporter::appleseedName() const
+void DagNodeExporter::hashFrameState(MurmurHash& hash) const
+{
+    const MMatrix m = dagPath().inclusiveMatrix();
+    for(int i = 0; i < 4; ++i)
+    {
+        for(int j = 0; j < 4; ++j)
+            hash.append(m[i][j]);
+    }
+
+    // Nodes with animated attributes are updated every frame.
+    if (MAnimUtil::isAnimated(node()))
+        hash.append(MAnimControl::currentTime().value());
+}
+
+const MString& DagNodeExporter::appleseedName() const
 {
-    return dagPath().fullPathName();
+    return fullPathName();
+}
+
+const MString& DagNodeExporter::appleseedName(const EntityNames::Suffix suffix) const
+{
+    if (m_names[suffix] == 0)
+        m_names[suffix] = &EntityNames::get(fullPathName(), suffix);
+
+    return *m_names[suffix];
 }
 
 const MDagPath& DagNodeExporter::dagPath() const
@@ -118,6 +148,11 @@ const MDagPath& DagNodeExporter::dagPath() const
     return m_path;
 }
 
+const MString& DagNodeExporter::fullPathName() const
+{
+    return *m_names[EntityNames::NoSuffix];
+}
+
 asf::Matrix4d DagNodeExporter::convert(const MMatrix& m) const
 {
     asf::Matrix4d result;
@@ -133,31 +168,25 @@ asf::Matrix4d DagNodeExporter::convert(const MMatrix& m) const
 
 void DagNodeExporter::visibilityAttributesToParams(asr::ParamArray& params)
 {
+    static const char* VisibilityAttributes[][2] =
+    {
+        {"asVisibilityCamera"   , "camera"},
+        {"asVisibilityLight"    , "light"},
+        {"asVisibilityShadow"   , "shadow"},
+        {"asVisibilityDiffuse"  , "diffuse"},
+        {"asVisibilitySpecular" , "specular"},
+        {"asVisibilityGlossy"   , "glossy"}
+    };
+
+    MFnDependencyNode depNodeFn(node());
     asf::Dictionary visFlags;
 
-    bool flag = true;
-    if(AttributeUtils::get(node(), "asVisibilityCamera", flag))
-        visFlags.insert("camera", flag);
-
-    flag = true;
-    if (AttributeUtils::get(node(), "asVisibilityLight", flag))
-        visFlags.insert("light", flag);
-
-    flag = true;
-    if (AttributeUtils::get(node(), "asVisibilityShadow", flag))
-        visFlags.insert("shadow", flag);
-
-    flag = true;
-    if (AttributeUtils::get(node(), "asVisibilityDiffuse", flag))
-        visFlags.insert("diffuse", flag);
-
-    flag = true;
-    if (AttributeUtils::get(node(), "asVisibilitySpecular", flag))
-        visFlags.insert("specular", flag);
-
-    flag = true;
-    if (AttributeUtils::get(node(), "asVisibilityGlossy", flag))
-        visFlags.insert("glossy", flag);
+    for(size_t i = 0, e = sizeof(VisibilityAttributes) / sizeof(VisibilityAttributes[0]); i < e; ++i)
+    {
+        bool flag = true;
+        if (AttributeUtils::get(depNodeFn, VisibilityAttributes[i][0], flag))
+            visFlags.insert(VisibilityAttributes[i][1], flag);
+    }
 
     params.insert("visibility", visFlags);
 }
@@ -205,3 +234,46 @@ bool DagNodeExporter::areObjectAndParentsRenderable(const MDagPath& path)
 
     return true;
 }
+
+void DagRenderability::reset()
+{
+    m_renderable.clear();
+}
+
+bool DagRenderability::visit(const MDagPath& path)
+{
+    // The world node.
+    const size_t depth = path.length();
+    if (depth == 0)
+    {
+        m_renderable.clear();
+        return true;
+    }
+
+    bool renderable = DagNodeExporter::isObjectRenderable(path);
+
+    if (depth > 1)
+    {
+        // The walk started below the world: evaluate the parents once.
+        if (m_renderable.size() + 1 < depth)
+        {
+            m_renderable.resize(depth - 1);
+
+            MDagPath parent(path);
+            for(size_t i = depth - 1; i > 0; --i)
+            {
+                parent.pop();
+                m_renderable[i - 1] = DagNodeExporter::isObjectRenderable(parent);
+            }
+
+            for(size_t i = 1; i < depth - 1; ++i)
+                m_renderable[i] = m_renderable[i] && m_renderable[i - 1];
+        }
+
+        renderable = renderable && m_renderable[depth - 2];
+    }
+
+    m_renderable.resize(depth);
+    m_renderable[depth - 1] = renderable;
+    return renderable;
+}
@@ -32,6 +32,9 @@
 // Forward declaration header.
 #include "dagnodeexporterfwd.h"
 
+// Standard headers.
+#include <vector>
+
 // Maya headers.
 #include <maya/MDagPath.h>
 #include <maya/MMatrix.h>
@@ -47,6 +50,7 @@
 
 // appleseed.maya headers.
 #include "appleseedmaya/appleseedsession.h"
+#include "appleseedmaya/entitynames.h"
 #include "appleseedmaya/utils.h"
 
 // Forward declarations.
@@ -54,6 +58,7 @@ namespace renderer { class Assembly; }
 namespace renderer { class Project; }
 namespace renderer { class Scene; }
 class MotionBlurTimes;
+class MurmurHash;
 
 class DagNodeExporter
   : public NonCopyable
@@ -64,7 +69,17 @@ class DagNodeExporter
     virtual ~DagNodeExporter();
 
     // Return the name of the entity in the appleseed project.
-    MString appleseedName() const;
+    const MString& appleseedName() const;
+
+    // Return the name of the entity followed by suffix.
+    // Names are interned and built once per exporter.
+    const MString& appleseedName(const EntityNames::Suffix suffix) const;
+
+    // Return the Maya dag path.
+    const MDagPath& dagPath() const;
+
+    // Return the full path name of the dag node, computed once.
+    const MString& fullPathName() const;
 
     // Return true if the entity created by this exporter can be motion blurred.
     virtual bool supportsMotionBlur() const;
@@ -84,6 +99,16 @@ class DagNodeExporter
     // Flush entities to the renderer.
     virtual void flushEntities() = 0;
 
+    // Hash the state of the node that can change from frame to frame.
+    // Used to find which entities need to be updated when rendering sequences.
+    virtual void hashFrameState(MurmurHash& hash) const;
+
+    // Return true if the node is not an intermediate object and is not hidden or templated.
+    static bool isObjectRenderable(const MDagPath& path);
+
+    // Return true if the node and all its parents are renderable.
+    static bool areObjectAndParentsRenderable(const MDagPath& path);
+
   protected:
 
     DagNodeExporter(
@@ -94,9 +119,6 @@ class DagNodeExporter
     // Return the Maya dependency node.
     MObject node() const;
 
-    // Return the Maya dag path.
-    const MDagPath& dagPath() const;
-
     // Return the session mode.
     AppleseedSession::SessionMode sessionMode() const;
 
@@ -114,16 +136,36 @@ class DagNodeExporter
 
     void visibilityAttributesToParams(renderer::ParamArray& params);
 
-    static bool isObjectRenderable(const MDagPath& path);
-    static bool areObjectAndParentsRenderable(const MDagPath& path);
-
   private:
 
     MDagPath                      m_path;
+    mutable const MString*        m_names[EntityNames::NumSuffixes];
     AppleseedSession::SessionMode m_sessionMode;
     renderer::Project&            m_project;
     renderer::Scene&              m_scene;
     renderer::Assembly&           m_mainAssembly;
 };
 
+//
+// Evaluates the world space renderability of the nodes visited by a
+// depth first dag walk, inheriting the state of the parents instead of
+// walking up the path of every node.
+//
+
+class DagRenderability
+{
+  public:
+
+    // Start a new walk.
+    void reset();
+
+    // Return true if the node and all its parents are renderable.
+    // Nodes must be visited in depth first order.
+    bool visit(const MDagPath& path);
+
+  private:
+
+    std::vector<bool> m_renderable;
+};
+
 #endif  // !APPLESEED_MAYA_EXPORTERS_DAGNODEEXPORTER_H
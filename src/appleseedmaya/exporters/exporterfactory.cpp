@@ -61,9 +61,15 @@ namespace asr = renderer;
 namespace
 {
 
+struct DagExporterEntry
+{
+    NodeExporterFactory::CreateDagNodeExporterFn    m_createFn;
+    bool                                            m_renderableOnly;
+};
+
 typedef std::map<
     MString,
-    NodeExporterFactory::CreateDagNodeExporterFn,
+    DagExporterEntry,
     MStringCompareLess
     > CreateDagExporterMapType;
 
@@ -104,11 +110,14 @@ MStatus NodeExporterFactory::uninitialize()
 
 void NodeExporterFactory::registerDagNodeExporter(
     const MString&                  mayaTypeName,
-    CreateDagNodeExporterFn         createFn)
+    CreateDagNodeExporterFn         createFn,
+    const bool                      renderableOnly)
 {
     assert(createFn != 0);
 
-    gDagNodeExporters[mayaTypeName] = createFn;
+    DagExporterEntry& entry = gDagNodeExporters[mayaTypeName];
+    entry.m_createFn = createFn;
+    entry.m_renderableOnly = renderableOnly;
 
     RENDERER_LOG_DEBUG(
         "NodeExporterFactory: registered dag node exporter for node %s",
@@ -117,6 +126,7 @@ void NodeExporterFactory::registerDagNodeExporter(
 
 DagNodeExporter* NodeExporterFactory::createDagNodeExporter(
     const MDagPath&                 path,
+    const bool                      renderable,
     asr::Project&                   project,
     AppleseedSession::SessionMode   sessionMode)
 {
@@ -126,7 +136,10 @@ DagNodeExporter* NodeExporterFactory::createDagNodeExporter(
     if (it == gDagNodeExporters.end())
         throw NoExporterForNode();
 
-    return it->second(path, project, sessionMode);
+    if (it->second.m_renderableOnly && !renderable)
+        return 0;
+
+    return it->second.m_createFn(path, project, sessionMode);
 }
 
 ShadingEngineExporter* NodeExporterFactory::createShadingEngineExporter(
@@ -60,12 +60,18 @@ class NodeExporterFactory
         renderer::Project&,
         AppleseedSession::SessionMode);
 
+    // If renderableOnly is true, no exporter is created for nodes
+    // that are hidden, templated or have a hidden parent.
     static void registerDagNodeExporter(
         const MString&                  mayaTypeName,
-        CreateDagNodeExporterFn         createFn);
+        CreateDagNodeExporterFn         createFn,
+        const bool                      renderableOnly = false);
 
+    // renderable is the world space renderability of the node,
+    // usually computed during the dag walk (see DagRenderability).
     static DagNodeExporter* createDagNodeExporter(
         const MDagPath&                 path,
+        const bool                      renderable,
         renderer::Project&              project,
         AppleseedSession::SessionMode   sessionMode);
 
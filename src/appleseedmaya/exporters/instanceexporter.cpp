@@ -34,6 +34,7 @@
 
 // appleseed.maya headers.
 #include "appleseedmaya/appleseedsession.h"
+#include "appleseedmaya/entitynames.h"
 
 namespace asf = foundation;
 namespace asr = renderer;
@@ -45,7 +46,7 @@ InstanceExporter::InstanceExporter(
     asr::Project&                   project,
     const asr::TransformSequence&   transformSequence)
   : ShapeExporter(path, project, sessionMode)
-  , m_masterShapeName(master.appleseedName())
+  , m_masterAssemblyName(master.appleseedName(EntityNames::AssemblySuffix))
 {
     m_transformSequence = transformSequence;
     master.instanceCreated();
@@ -53,8 +54,8 @@ InstanceExporter::InstanceExporter(
 
 void InstanceExporter::flushEntities()
 {
-    const MString assemblyName = m_masterShapeName + MString("_assembly");
-    const MString assemblyInstanceName = appleseedName() + MString("_instance");
+    const MString& assemblyName = m_masterAssemblyName;
+    const MString& assemblyInstanceName = appleseedName(EntityNames::InstanceSuffix);
 
     asr::ParamArray params;
     visibilityAttributesToParams(params);
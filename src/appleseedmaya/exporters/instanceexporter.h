@@ -57,7 +57,7 @@ class InstanceExporter
 
   private:
 
-    MString m_masterShapeName;
+    const MString& m_masterAssemblyName;
 };
 
 #endif  // !APPLESEED_MAYA_EXPORTERS_INSTANCEEXPORTER_H
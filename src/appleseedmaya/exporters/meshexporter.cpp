@@ -41,16 +41,16 @@
 #include <maya/MFloatPointArray.h>
 #include <maya/MFnMesh.h>
 #include <maya/MItDependencyGraph.h>
-#include <maya/MItMeshPolygon.h>
-#include <maya/MPointArray.h>
 
 // appleseed.foundation headers.
 #include "foundation/utility/string.h"
 
 // appleseed.maya headers.
 #include "appleseedmaya/attributeutils.h"
+#include "appleseedmaya/entitynames.h"
 #include "appleseedmaya/exporters/exporterfactory.h"
 #include "appleseedmaya/logger.h"
+#include "appleseedmaya/meshutils.h"
 
 namespace bfs = boost::filesystem;
 namespace asf = foundation;
@@ -129,7 +129,7 @@ void meshObjectHash(
 
 void MeshExporter::registerExporter()
 {
-    NodeExporterFactory::registerDagNodeExporter("mesh", &MeshExporter::create);
+    NodeExporterFactory::registerDagNodeExporter("mesh", &MeshExporter::create, true);
 }
 
 DagNodeExporter *MeshExporter::create(
@@ -137,9 +137,6 @@ DagNodeExporter *MeshExporter::create(
     asr::Project&                   project,
     AppleseedSession::SessionMode   sessionMode)
 {
-    if (areObjectAndParentsRenderable(path) == false)
-        return 0;
-
     return new MeshExporter(path, project, sessionMode);
 }
 
@@ -175,7 +172,7 @@ void MeshExporter::createExporters(const AppleseedSession::Services& services)
         MObject shadingEngine = connections[0].node();
         services.createShadingEngineExporter(shadingEngine);
         depNodeFn.setObject(shadingEngine);
-        MString materialName = depNodeFn.name() + MString("_material");
+        const MString& materialName = EntityNames::get(depNodeFn.name(), EntityNames::MaterialSuffix);
         m_materialMappings.insert("default", materialName.asChar());
     }
     else
@@ -188,7 +185,7 @@ void MeshExporter::createExporters(const AppleseedSession::Services& services)
         {
             services.createShadingEngineExporter(shadingEngines[i]);
             depNodeFn.setObject(shadingEngines[i]);
-            MString materialName = depNodeFn.name() + MString("_material");
+            const MString& materialName = EntityNames::get(depNodeFn.name(), EntityNames::MaterialSuffix);
 
             if (i == 0)
                 m_materialMappings.insert("default", materialName.asChar());
@@ -214,7 +211,6 @@ void MeshExporter::createEntities(const AppleseedSession::Options& options)
     meshAttributesToParams(m_meshParams);
 
     MFnMesh meshFn(dagPath());
-    m_exportUVs = meshFn.numUVs() != 0;
     m_exportNormals = meshFn.numNormals() != 0;
     m_shapeExportStep = 0;
 
@@ -324,6 +320,23 @@ void MeshExporter::flushEntities()
     createObjectInstance(objectName);
 }
 
+void MeshExporter::hashFrameState(MurmurHash& hash) const
+{
+    ShapeExporter::hashFrameState(hash);
+
+    MStatus status;
+    MFnMesh meshFn(dagPath());
+
+    hash.append(meshFn.numPolygons());
+    hash.append(meshFn.numVertices());
+    if (const float *p = meshFn.getRawPoints(&status))
+        hash.append(p, meshFn.numVertices() * 3 * sizeof(float));
+
+    hash.append(meshFn.numNormals());
+    if (const float *p = meshFn.getRawNormals(&status))
+        hash.append(p, meshFn.numNormals() * 3 * sizeof(float));
+}
+
 void MeshExporter::meshAttributesToParams(renderer::ParamArray& params)
 {
     int mediumPriority = 0;
@@ -348,132 +361,12 @@ void MeshExporter::createMaterialSlots()
 
 void MeshExporter::fillTopology()
 {
-    MStatus status;
-
-    // Triangle buffer.
-    std::vector<asr::Triangle> triangles;
-
-    MIntArray faceVertexIndices;
-    MIntArray faceUVIndices;
-    MIntArray faceNormalIndices;
-    MIntArray triangleVertexIndices;
-    MPointArray trianglePoints;
-
-    MItMeshPolygon faceIt(dagPath());
-    for(; !faceIt.isDone(); faceIt.next())
-    {
-        // Get the material index for this face.
-        int materialIndex = 0;
-        if (m_perFaceAssignments.length() != 0)
-            materialIndex = m_perFaceAssignments[faceIt.index()];
-
-        // Collect normal and uv indices for this face.
-        faceUVIndices.clear();
-        faceNormalIndices.clear();
-
-        faceIt.getVertices(faceVertexIndices);
-        for(size_t i = 0, e = faceVertexIndices.length(); i < e; ++i)
-        {
-            if (m_exportUVs)
-            {
-                int uvIndex;
-                status = faceIt.getUVIndex(i, uvIndex);
-                faceUVIndices.append(uvIndex);
-            }
-
-            if (m_exportNormals)
-            {
-                unsigned int normalIndex = faceIt.normalIndex(i, &status);
-                faceNormalIndices.append(normalIndex);
-            }
-        }
-
-        // Match the triangle indices to the face indices.
-        int numTris;
-        faceIt.numTriangles(numTris);
-        for(size_t i = 0; i < numTris; ++i)
-        {
-            trianglePoints.clear();
-            triangleVertexIndices.clear();
-            faceIt.getTriangle(i, trianglePoints, triangleVertexIndices);
-
-            int triangleVertexOffset[3] = {-1, -1, -1};
-            for(size_t j = 0, je = faceVertexIndices.length(); j < je; ++j)
-            {
-                if (faceVertexIndices[j] == triangleVertexIndices[0])
-                    triangleVertexOffset[0] = j;
-                else if (faceVertexIndices[j] == triangleVertexIndices[1])
-                    triangleVertexOffset[1] = j;
-                else if (faceVertexIndices[j] == triangleVertexIndices[2])
-                    triangleVertexOffset[2] = j;
-            }
-
-            // Reverse the direction of the triangle.
-            std::swap(triangleVertexOffset[0], triangleVertexOffset[2]);
-
-            asr::Triangle triangle(
-                faceVertexIndices[triangleVertexOffset[0]],
-                faceVertexIndices[triangleVertexOffset[1]],
-                faceVertexIndices[triangleVertexOffset[2]],
-                materialIndex);
-
-            if (m_exportUVs)
-            {
-                triangle.m_a0 = faceUVIndices[triangleVertexOffset[0]];
-                triangle.m_a1 = faceUVIndices[triangleVertexOffset[1]];
-                triangle.m_a2 = faceUVIndices[triangleVertexOffset[2]];
-            }
-
-            if (m_exportNormals)
-            {
-                triangle.m_n0 = faceNormalIndices[triangleVertexOffset[0]];
-                triangle.m_n1 = faceNormalIndices[triangleVertexOffset[1]];
-                triangle.m_n2 = faceNormalIndices[triangleVertexOffset[2]];
-            }
-
-            triangles.push_back(triangle);
-        }
-    }
-
-    // Copy triangles to the mesh.
-    m_mesh->reserve_triangles(triangles.size());
-    for(size_t i = 0, e = triangles.size(); i < e; ++i)
-        m_mesh->push_triangle(triangles[i]);
+    MeshUtils::copyTopology(node(), m_perFaceAssignments, *m_mesh);
 }
 
 void MeshExporter::exportGeometry()
 {
-    MStatus status;
-    MFnMesh meshFn(dagPath());
-
-    // Vertices.
-    m_mesh->reserve_vertices(meshFn.numVertices());
-    {
-        const float *p = meshFn.getRawPoints(&status);
-        for(size_t i = 0, e = meshFn.numVertices(); i < e; ++i, p += 3)
-            m_mesh->push_vertex(asr::GVector3(p[0], p[1], p[2]));
-    }
-
-    if (m_exportUVs)
-    {
-        m_mesh->reserve_tex_coords(meshFn.numUVs());
-        MFloatArray u, v;
-        status = meshFn.getUVs(u, v);
-        for(size_t i = 0, e = meshFn.numUVs(); i < e; ++i)
-            m_mesh->push_tex_coords(asr::GVector2(u[i], v[i]));
-    }
-
-    if (m_exportNormals)
-    {
-        m_mesh->reserve_vertex_normals(meshFn.numNormals());
-        const float *p = meshFn.getRawNormals(&status);
-
-        for(size_t i = 0, e = meshFn.numNormals(); i < e; ++i, p += 3)
-        {
-            asr::GVector3 n(p[0], p[1], p[2]);
-            m_mesh->push_vertex_normal(asf::safe_normalize(n));
-        }
-    }
+    MeshUtils::copyGeometry(node(), *m_mesh);
 }
 
 void MeshExporter::exportMeshKey()
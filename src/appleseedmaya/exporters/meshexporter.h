@@ -70,6 +70,8 @@ class MeshExporter
 
     virtual void flushEntities();
 
+    virtual void hashFrameState(MurmurHash& hash) const;
+
   private:
 
     MeshExporter(
@@ -86,7 +88,6 @@ class MeshExporter
 
     AppleseedEntityPtr<renderer::MeshObject>      m_mesh;
     renderer::ParamArray                          m_meshParams;
-    bool                                          m_exportUVs;
     bool                                          m_exportNormals;
     std::vector<std::string>                      m_fileNames;
     MIntArray                                     m_perFaceAssignments;
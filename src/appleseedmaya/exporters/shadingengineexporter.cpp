@@ -38,6 +38,7 @@
 #include "renderer/api/scene.h"
 
 // appleseed.maya headers.
+#include "appleseedmaya/entitynames.h"
 #include "appleseedmaya/exporters/shadingnetworkexporter.h"
 
 namespace asf = foundation;
@@ -105,7 +106,7 @@ void ShadingEngineExporter::createEntities(const AppleseedSession::Options& opti
     */
 
     // Create the material.
-    MString materialName = appleseedName + MString("_material");
+    const MString& materialName = EntityNames::get(appleseedName, EntityNames::MaterialSuffix);
     m_material.reset(asr::OSLMaterialFactory().create(
         materialName.asChar(), asr::ParamArray()));
 
@@ -152,6 +152,11 @@ void ShadingNetworkExporter::flushEntities()
         m_shaderGroup);
 }
 
+bool ShadingNetworkExporter::containsNode(const MString& nodeName) const
+{
+    return m_namesToExporters.count(nodeName) != 0;
+}
+
 void ShadingNetworkExporter::createShaderNodeExporters(const MObject& node)
 {
     MStatus status;
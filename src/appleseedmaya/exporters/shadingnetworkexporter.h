@@ -68,6 +68,9 @@ class ShadingNetworkExporter
     // Flush entities to the renderer.
     void flushEntities();
 
+    // Return true if the node is part of the exported network.
+    bool containsNode(const MString& nodeName) const;
+
   private:
     friend class NodeExporterFactory;
 
@@ -48,7 +48,7 @@ ShapeExporter::~ShapeExporter()
 {
     if (sessionMode() == AppleseedSession::ProgressiveRenderSession)
     {
-        if (m_objectAssembly.get() == 0)
+        if (m_objectAssembly.get() != 0)
         {
             mainAssembly().assemblies().remove(m_objectAssembly.get());
             mainAssembly().assembly_instances().remove(m_objectAssemblyInstance.get());
@@ -84,13 +84,13 @@ void ShapeExporter::flushEntities()
     if (sessionMode() == AppleseedSession::ProgressiveRenderSession ||
        m_numInstances > 0 || m_transformSequence.size() > 1)
     {
-        const MString assemblyName = appleseedName() + MString("_assembly");
+        const MString& assemblyName = appleseedName(EntityNames::AssemblySuffix);
         m_objectAssembly.reset(
             asr::AssemblyFactory().create(assemblyName.asChar(), asr::ParamArray()));
 
         mainAssembly().assemblies().insert(m_objectAssembly.release());
 
-        const MString assemblyInstanceName = assemblyName + MString("_instance");
+        const MString& assemblyInstanceName = appleseedName(EntityNames::AssemblyInstanceSuffix);
 
         asr::ParamArray params;
         visibilityAttributesToParams(params);
@@ -126,7 +126,7 @@ void ShapeExporter::createObjectInstance(const MString& objectName)
         visibilityAttributesToParams(params);
     }
 
-    const MString objectInstanceName = appleseedName() + MString("_instance");
+    const MString& objectInstanceName = appleseedName(EntityNames::InstanceSuffix);
     m_objectInstance.reset(
         asr::ObjectInstanceFactory::create(
             objectInstanceName.asChar(),
@@ -81,7 +81,7 @@ void XGenExporter::createExporters(const AppleseedSession::Services& services)
 
 void XGenExporter::createEntities(const AppleseedSession::Options& options)
 {
-    const MString assemblyName = appleseedName() + MString("_assembly");
+    const MString& assemblyName = appleseedName(EntityNames::AssemblySuffix);
     asr::ParamArray params;
 
     // Ported from XGen's sample mtoa extension code.
@@ -163,7 +163,7 @@ void XGenExporter::flushEntities()
 {
     mainAssembly().assemblies().insert(m_assembly.release());
 
-    const MString assemblyInstanceName = appleseedName() + MString("_assembly_instance");
+    const MString& assemblyInstanceName = appleseedName(EntityNames::AssemblyInstanceSuffix);
     asr::ParamArray params;
     visibilityAttributesToParams(params);
     m_assemblyInstance.reset(
@@ -0,0 +1,399 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "appleseedmaya/framecheckpoint.h"
+
+// Standard headers.
+#include <cstring>
+#include <fstream>
+
+// Boost headers.
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
+#include "foundation/image/tile.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/frame.h"
+#include "renderer/api/log.h"
+
+namespace asf = foundation;
+namespace asr = renderer;
+namespace bfs = boost::filesystem;
+
+namespace
+{
+
+const char CheckpointMagic[8] = { 'A', 'S', 'M', 'C', 'K', 'P', 'T', '1' };
+
+struct CheckpointHeader
+{
+    char            m_magic[8];
+    boost::uint64_t m_valueCount;       // Number of floats following the header.
+    boost::uint32_t m_width;
+    boost::uint32_t m_height;
+    boost::uint32_t m_passCount;
+    boost::uint32_t m_completedPasses;
+};
+
+size_t imageValueCount(const asf::Image& image)
+{
+    const asf::CanvasProperties& props = image.properties();
+    return props.m_pixel_count * props.m_channel_count;
+}
+
+size_t frameValueCount(const asr::Frame& frame)
+{
+    size_t count = imageValueCount(frame.image());
+
+    const asr::ImageStack& aovImages = frame.aov_images();
+    for (size_t i = 0, e = aovImages.size(); i < e; ++i)
+        count += imageValueCount(aovImages.get_image(i));
+
+    return count;
+}
+
+// Copy the pixels of an image, tile by tile.
+float* readImage(const asf::Image& image, float* dst)
+{
+    const asf::CanvasProperties& props = image.properties();
+
+    for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+    {
+        for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
+        {
+            const asf::Tile& tile = image.tile(tx, ty);
+
+            for (size_t y = 0, h = tile.get_height(); y < h; ++y)
+            {
+                for (size_t x = 0, w = tile.get_width(); x < w; ++x, dst += props.m_channel_count)
+                    tile.get_pixel(x, y, dst);
+            }
+        }
+    }
+
+    return dst;
+}
+
+const float* writeImage(const float* src, asf::Image& image)
+{
+    const asf::CanvasProperties& props = image.properties();
+
+    for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+    {
+        for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
+        {
+            asf::Tile& tile = image.tile(tx, ty);
+
+            for (size_t y = 0, h = tile.get_height(); y < h; ++y)
+            {
+                for (size_t x = 0, w = tile.get_width(); x < w; ++x, src += props.m_channel_count)
+                    tile.set_pixel(x, y, src);
+            }
+        }
+    }
+
+    return src;
+}
+
+void readFrame(const asr::Frame& frame, std::vector<float>& values)
+{
+    values.resize(frameValueCount(frame));
+    float* dst = readImage(frame.image(), &values[0]);
+
+    const asr::ImageStack& aovImages = frame.aov_images();
+    for (size_t i = 0, e = aovImages.size(); i < e; ++i)
+        dst = readImage(aovImages.get_image(i), dst);
+}
+
+void writeFrame(const std::vector<float>& values, asr::Frame& frame)
+{
+    const float* src = writeImage(&values[0], frame.image());
+
+    asr::ImageStack& aovImages = frame.aov_images();
+    for (size_t i = 0, e = aovImages.size(); i < e; ++i)
+        src = writeImage(src, aovImages.get_image(i));
+}
+
+// Average the values of two renders, weighted by their number of passes.
+void blendPasses(
+    const std::vector<float>&   resumedValues,
+    const size_t                resumedPasses,
+    std::vector<float>&         values,
+    const size_t                renderedPasses)
+{
+    if (resumedPasses == 0)
+        return;
+
+    const float w = static_cast<float>(renderedPasses) / (resumedPasses + renderedPasses);
+
+    for (size_t i = 0, e = values.size(); i < e; ++i)
+        values[i] = resumedValues[i] + (values[i] - resumedValues[i]) * w;
+}
+
+class FrameCheckpointTileCallback
+  : public asr::ITileCallback
+{
+  public:
+    explicit FrameCheckpointTileCallback(FrameCheckpoint& checkpoint)
+      : m_checkpoint(checkpoint)
+    {
+    }
+
+    virtual void release()
+    {
+        delete this;
+    }
+
+    virtual void pre_render(
+        const size_t        x,
+        const size_t        y,
+        const size_t        width,
+        const size_t        height)
+    {
+    }
+
+    virtual void post_render(
+        const asr::Frame*   frame)
+    {
+        m_checkpoint.passRendered(*frame);
+    }
+
+    virtual void post_render_tile(
+        const asr::Frame*   frame,
+        const size_t        tile_x,
+        const size_t        tile_y)
+    {
+    }
+
+  private:
+    FrameCheckpoint& m_checkpoint;
+};
+
+} // unnamed.
+
+FrameCheckpoint::FrameCheckpoint()
+  : m_interval(0.0)
+  , m_passCount(0)
+  , m_resumedPasses(0)
+  , m_renderedPasses(0)
+  , m_lastWriteTime(0)
+{
+}
+
+void FrameCheckpoint::start(
+    const std::string&  fileName,
+    const double        interval,
+    const size_t        passCount)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    m_fileName = fileName;
+    m_interval = interval;
+    m_passCount = passCount;
+    m_resumedPasses = 0;
+    m_renderedPasses = 0;
+    m_resumedValues.clear();
+    m_lastWriteTime = m_timer.read();
+}
+
+size_t FrameCheckpoint::resume(const renderer::Frame& frame)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    m_resumedPasses = 0;
+    m_resumedValues.clear();
+
+    std::ifstream file(m_fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!file)
+        return 0;
+
+    CheckpointHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(CheckpointHeader));
+
+    const asf::CanvasProperties& props = frame.image().properties();
+
+    if (!file ||
+        std::memcmp(header.m_magic, CheckpointMagic, sizeof(CheckpointMagic)) != 0 ||
+        header.m_width != props.m_canvas_width ||
+        header.m_height != props.m_canvas_height ||
+        header.m_valueCount != frameValueCount(frame) ||
+        header.m_passCount != m_passCount ||
+        header.m_completedPasses == 0 ||
+        header.m_completedPasses >= m_passCount)
+    {
+        RENDERER_LOG_WARNING(
+            "appleseedMaya: checkpoint %s does not match the frame, rendering from the start.",
+            m_fileName.c_str());
+        return 0;
+    }
+
+    m_resumedValues.resize(static_cast<size_t>(header.m_valueCount));
+    file.read(reinterpret_cast<char*>(&m_resumedValues[0]), m_resumedValues.size() * sizeof(float));
+
+    if (!file)
+    {
+        RENDERER_LOG_WARNING(
+            "appleseedMaya: could not read checkpoint %s, rendering from the start.",
+            m_fileName.c_str());
+        m_resumedValues.clear();
+        return 0;
+    }
+
+    m_resumedPasses = header.m_completedPasses;
+
+    RENDERER_LOG_INFO(
+        "appleseedMaya: resuming from checkpoint %s, %u of %u passes already rendered.",
+        m_fileName.c_str(),
+        static_cast<unsigned int>(m_resumedPasses),
+        static_cast<unsigned int>(m_passCount));
+
+    return m_resumedPasses;
+}
+
+void FrameCheckpoint::passRendered(const renderer::Frame& frame)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    if (m_fileName.empty())
+        return;
+
+    ++m_renderedPasses;
+    const size_t completedPasses = m_resumedPasses + m_renderedPasses;
+
+    // Nothing to save after the last pass, the render is complete.
+    if (completedPasses >= m_passCount)
+        return;
+
+    const double elapsed = static_cast<double>(m_timer.read() - m_lastWriteTime) / m_timer.frequency();
+    if (elapsed < m_interval)
+        return;
+
+    std::vector<float> values;
+    readFrame(frame, values);
+    blendPasses(m_resumedValues, m_resumedPasses, values, m_renderedPasses);
+
+    if (write(frame, values, completedPasses))
+    {
+        RENDERER_LOG_INFO(
+            "appleseedMaya: wrote checkpoint %s, %u of %u passes rendered.",
+            m_fileName.c_str(),
+            static_cast<unsigned int>(completedPasses),
+            static_cast<unsigned int>(m_passCount));
+    }
+
+    m_lastWriteTime = m_timer.read();
+}
+
+void FrameCheckpoint::finish(renderer::Frame& frame)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    if (m_fileName.empty())
+        return;
+
+    if (m_resumedPasses > 0)
+    {
+        std::vector<float> values;
+        readFrame(frame, values);
+        blendPasses(m_resumedValues, m_resumedPasses, values, m_renderedPasses);
+        writeFrame(values, frame);
+    }
+
+    boost::system::error_code ec;
+    bfs::remove(bfs::path(m_fileName), ec);
+
+    m_fileName.clear();
+    m_resumedPasses = 0;
+    m_resumedValues.clear();
+}
+
+bool FrameCheckpoint::write(
+    const renderer::Frame&      frame,
+    const std::vector<float>&   values,
+    const size_t                completedPasses) const
+{
+    const asf::CanvasProperties& props = frame.image().properties();
+
+    CheckpointHeader header;
+    std::memcpy(header.m_magic, CheckpointMagic, sizeof(CheckpointMagic));
+    header.m_valueCount = values.size();
+    header.m_width = static_cast<boost::uint32_t>(props.m_canvas_width);
+    header.m_height = static_cast<boost::uint32_t>(props.m_canvas_height);
+    header.m_passCount = static_cast<boost::uint32_t>(m_passCount);
+    header.m_completedPasses = static_cast<boost::uint32_t>(completedPasses);
+
+    // Write to a temporary file first, so that a render killed while
+    // writing does not lose the previous checkpoint.
+    const std::string tmpFileName = m_fileName + ".tmp";
+
+    {
+        std::ofstream file(tmpFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(CheckpointHeader));
+        file.write(reinterpret_cast<const char*>(&values[0]), values.size() * sizeof(float));
+
+        if (!file)
+        {
+            RENDERER_LOG_ERROR("appleseedMaya: could not write checkpoint %s.", tmpFileName.c_str());
+            return false;
+        }
+    }
+
+    boost::system::error_code ec;
+    bfs::rename(bfs::path(tmpFileName), bfs::path(m_fileName), ec);
+
+    if (ec)
+    {
+        RENDERER_LOG_ERROR(
+            "appleseedMaya: could not write checkpoint %s: %s",
+            m_fileName.c_str(),
+            ec.message().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+FrameCheckpointTileCallbackFactory::FrameCheckpointTileCallbackFactory(FrameCheckpoint& checkpoint)
+  : m_checkpoint(checkpoint)
+{
+}
+
+void FrameCheckpointTileCallbackFactory::release()
+{
+    delete this;
+}
+
+renderer::ITileCallback* FrameCheckpointTileCallbackFactory::create()
+{
+    return new FrameCheckpointTileCallback(m_checkpoint);
+}
@@ -0,0 +1,120 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_MAYA_FRAME_CHECKPOINT_H
+#define APPLESEED_MAYA_FRAME_CHECKPOINT_H
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Boost headers.
+#include "boost/cstdint.hpp"
+#include "boost/noncopyable.hpp"
+#include "boost/thread/mutex.hpp"
+
+// appleseed.foundation headers.
+#include "foundation/platform/defaulttimers.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/rendering.h"
+
+// Forward declarations.
+namespace renderer { class Frame; }
+
+//
+// FrameCheckpoint.
+//
+//  Saves the main image and the AOVs of a multi-pass render to a file at the
+//  end of a pass, at most once per interval. A render that was interrupted
+//  can then be resumed: the remaining passes are rendered with another noise
+//  seed and blended with the checkpoint, weighted by their number of passes.
+//
+//  This file does not depend on Maya.
+//
+
+class FrameCheckpoint
+  : boost::noncopyable
+{
+  public:
+    FrameCheckpoint();
+
+    // Start checkpointing a render of passCount passes.
+    void start(
+        const std::string&  fileName,
+        const double        interval,
+        const size_t        passCount);
+
+    // Load the checkpoint file if it matches the frame.
+    // Returns the number of passes already rendered, 0 if there is nothing to resume.
+    size_t resume(const renderer::Frame& frame);
+
+    // Called at the end of each rendered pass. Thread safe.
+    void passRendered(const renderer::Frame& frame);
+
+    // Blend the resumed passes into the frame and remove the checkpoint file.
+    // Called when the render is complete.
+    void finish(renderer::Frame& frame);
+
+  private:
+    bool write(
+        const renderer::Frame&      frame,
+        const std::vector<float>&   values,
+        const size_t                completedPasses) const;
+
+    boost::mutex                        m_mutex;
+    std::string                         m_fileName;
+    double                              m_interval;
+    size_t                              m_passCount;
+    size_t                              m_resumedPasses;
+    size_t                              m_renderedPasses;
+    std::vector<float>                  m_resumedValues;
+    foundation::DefaultWallclockTimer   m_timer;
+    boost::uint64_t                     m_lastWriteTime;
+};
+
+//
+// Tile callback factory saving checkpoints of the frame at the end of the passes of a master renderer.
+//
+
+class FrameCheckpointTileCallbackFactory
+  : public renderer::ITileCallbackFactory
+{
+  public:
+    explicit FrameCheckpointTileCallbackFactory(FrameCheckpoint& checkpoint);
+
+    virtual void release();
+
+    virtual renderer::ITileCallback* create();
+
+  private:
+    FrameCheckpoint& m_checkpoint;
+};
+
+#endif  // !APPLESEED_MAYA_FRAME_CHECKPOINT_H
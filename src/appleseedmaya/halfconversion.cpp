@@ -0,0 +1,113 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "appleseedmaya/halfconversion.h"
+
+// Standard headers.
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define APPLESEED_MAYA_USE_F16C
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+#ifdef APPLESEED_MAYA_USE_F16C
+__attribute__((target("avx,f16c")))
+size_t halfToFloatF16C(const boost::uint16_t* src, float* dst, const size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+
+    return i;
+}
+
+bool cpuHasF16C()
+{
+    static const bool hasF16C = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+    return hasF16C;
+}
+#endif
+
+} // unnamed.
+
+float halfToFloat(const boost::uint16_t h)
+{
+    const boost::uint32_t sign = static_cast<boost::uint32_t>(h & 0x8000) << 16;
+    boost::uint32_t exponent = (h >> 10) & 0x1F;
+    boost::uint32_t mantissa = h & 0x03FF;
+
+    boost::uint32_t bits;
+
+    if (exponent == 0)
+    {
+        if (mantissa == 0)
+            bits = sign;                                        // Zero.
+        else
+        {
+            // Denormal, normalize it.
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x0400) == 0)
+            {
+                mantissa <<= 1;
+                --exponent;
+            }
+
+            bits = sign | (exponent << 23) | ((mantissa & 0x03FF) << 13);
+        }
+    }
+    else if (exponent == 0x1F)
+        bits = sign | 0x7F800000 | (mantissa << 13);            // Infinity or NaN.
+    else
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+
+    float f;
+    std::memcpy(&f, &bits, sizeof(float));
+    return f;
+}
+
+void halfToFloat(const boost::uint16_t* src, float* dst, const size_t count)
+{
+    size_t i = 0;
+
+#ifdef APPLESEED_MAYA_USE_F16C
+    if (cpuHasF16C())
+        i = halfToFloatF16C(src, dst, count);
+#endif
+
+    for (; i < count; ++i)
+        dst[i] = halfToFloat(src[i]);
+}
@@ -0,0 +1,53 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_MAYA_HALF_CONVERSION_H
+#define APPLESEED_MAYA_HALF_CONVERSION_H
+
+// Standard headers.
+#include <cstddef>
+
+// Boost headers.
+#include "boost/cstdint.hpp"
+
+//
+// Half float to float conversion.
+//
+//  Uses the F16C instructions when the CPU supports them.
+//
+//  This file does not depend on Maya, it is also built into the
+//  appleseedMayaRender executable.
+//
+
+// Convert a single half float, stored as its bit pattern.
+float halfToFloat(const boost::uint16_t h);
+
+// Convert an array of half floats.
+void halfToFloat(const boost::uint16_t* src, float* dst, const size_t count);
+
+#endif  // !APPLESEED_MAYA_HALF_CONVERSION_H
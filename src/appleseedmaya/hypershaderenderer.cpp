@@ -29,6 +29,294 @@
 // Interface header.
 #include "appleseedmaya/hypershaderenderer.h"
 
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+
+// Boost headers.
+#include "boost/bind.hpp"
+#include "boost/shared_array.hpp"
+
+// Maya headers.
+#include <maya/MFnCamera.h>
+#include <maya/MFnDependencyNode.h>
+#include <maya/MIntArray.h>
+#include <maya/MPlug.h>
+#include <maya/MUuid.h>
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
+#include "foundation/image/tile.h"
+#include "foundation/math/matrix.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/camera.h"
+#include "renderer/api/color.h"
+#include "renderer/api/environment.h"
+#include "renderer/api/environmentedf.h"
+#include "renderer/api/environmentshader.h"
+#include "renderer/api/frame.h"
+#include "renderer/api/light.h"
+#include "renderer/api/material.h"
+#include "renderer/api/object.h"
+#include "renderer/api/project.h"
+#include "renderer/api/rendering.h"
+#include "renderer/api/scene.h"
+#include "renderer/api/shadergroup.h"
+
+// appleseed.maya headers.
+#include "appleseedmaya/appleseedsession.h"
+#include "appleseedmaya/attributeutils.h"
+#include "appleseedmaya/exporters/exporterfactory.h"
+#include "appleseedmaya/exporters/shadingnetworkexporter.h"
+#include "appleseedmaya/logger.h"
+#include "appleseedmaya/meshutils.h"
+#include "appleseedmaya/shadingnodemetadata.h"
+#include "appleseedmaya/shadingnoderegistry.h"
+
+namespace asf = foundation;
+namespace asr = renderer;
+
+namespace
+{
+
+const char* CameraName = "camera";
+
+// Preview frames are rendered at 1/8, 1/4 and 1/2 of the resolution.
+const size_t MaxPreviewScale = 8;
+const size_t MinPreviewSize = 16;
+
+asf::Matrix4d convert(const MMatrix& m)
+{
+    asf::Matrix4d result;
+
+    for(int i = 0; i < 4; ++i)
+    {
+        for(int j = 0; j < 4; ++j)
+            result(i, j) = m[j][i];
+    }
+
+    return result;
+}
+
+asf::Transformd convertTransform(const MMatrix& m)
+{
+    return asf::Transformd(convert(m), convert(m.inverse()));
+}
+
+MString materialName(const MString& shaderId)
+{
+    return shaderId + MString("_material");
+}
+
+// Return the first closure output of a shading node, if any.
+bool findSurfaceOutputPlug(const MObject& node, MPlug& outputPlug)
+{
+    MFnDependencyNode depNodeFn(node);
+    const OSLShaderInfo *shaderInfo = ShadingNodeRegistry::getShaderInfo(depNodeFn.typeName());
+    if (shaderInfo == 0)
+        return false;
+
+    for(size_t i = 0, e = shaderInfo->paramInfo.size(); i < e; ++i)
+    {
+        const OSLParamInfo& paramInfo = shaderInfo->paramInfo[i];
+        if (paramInfo.isOutput && paramInfo.isClosure)
+        {
+            MStatus status;
+            outputPlug = depNodeFn.findPlug(paramInfo.mayaAttributeName, &status);
+            return status == MS::kSuccess;
+        }
+    }
+
+    return false;
+}
+
+template <typename T, typename Container>
+void removeEntity(Container& container, const MString& name)
+{
+    if (T* entity = container.get_by_name(name.asChar()))
+        container.remove(entity);
+}
+
+asf::auto_release_ptr<asr::MeshObject> convertMesh(
+    const MString&  name,
+    const MObject&  node)
+{
+    asf::auto_release_ptr<asr::MeshObject> mesh(
+        asr::MeshObjectFactory::create(name.asChar(), asr::ParamArray()));
+    mesh->push_material_slot("default");
+
+    MeshUtils::copyGeometry(node, *mesh);
+    MeshUtils::copyTopology(node, MIntArray(), *mesh);
+
+    return mesh;
+}
+
+} // unnamed.
+
+//
+// Sends the progressive renderer's frames to the Hypershade.
+//
+//  Preview frames, rendered at a fraction of the display resolution,
+//  are upscaled by replicating their pixels. Each renderer has its own
+//  factory, its display size is changed by the render thread between frames.
+//
+
+class HypershadeTileCallback
+  : public asr::ITileCallback
+{
+  public:
+    explicit HypershadeTileCallback(const HypershadeTileCallbackFactory& factory)
+      : m_factory(factory)
+    {
+    }
+
+    virtual void release()
+    {
+        delete this;
+    }
+
+    virtual void pre_render(
+        const size_t        x,
+        const size_t        y,
+        const size_t        width,
+        const size_t        height)
+    {
+    }
+
+    virtual void post_render_tile(
+        const asr::Frame*   frame,
+        const size_t        tile_x,
+        const size_t        tile_y)
+    {
+    }
+
+    virtual void post_render(
+        const asr::Frame*   frame);
+
+  private:
+    const HypershadeTileCallbackFactory& m_factory;
+};
+
+class HypershadeTileCallbackFactory
+  : public asr::ITileCallbackFactory
+{
+  public:
+    HypershadeTileCallbackFactory()
+      : m_displayWidth(0)
+      , m_displayHeight(0)
+      , m_scale(1)
+    {
+    }
+
+    virtual void release()
+    {
+        delete this;
+    }
+
+    virtual asr::ITileCallback* create()
+    {
+        return new HypershadeTileCallback(*this);
+    }
+
+    // Frames are rendered at 1 / scale of the display resolution.
+    // Must be called before rendering.
+    void setDisplay(
+        const size_t        width,
+        const size_t        height,
+        const size_t        scale)
+    {
+        m_displayWidth = width;
+        m_displayHeight = height;
+        m_scale = scale;
+    }
+
+    size_t displayWidth() const     { return m_displayWidth; }
+    size_t displayHeight() const    { return m_displayHeight; }
+    size_t scale() const            { return m_scale; }
+
+  private:
+    size_t  m_displayWidth;
+    size_t  m_displayHeight;
+    size_t  m_scale;
+};
+
+void HypershadeTileCallback::post_render(
+    const asr::Frame*   frame)
+{
+    const asf::Image& image = frame->image();
+    const asf::CanvasProperties& props = image.properties();
+
+    const size_t width = props.m_canvas_width;
+    const size_t height = props.m_canvas_height;
+    boost::shared_array<float> pixels(new float[width * height * 4]);
+
+    for(size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+    {
+        for(size_t tx = 0; tx < props.m_tile_count_x; ++tx)
+        {
+            const asf::Tile& tile = image.tile(tx, ty);
+            const size_t x0 = tx * props.m_tile_width;
+            const size_t y0 = ty * props.m_tile_height;
+
+            for(size_t j = 0, je = tile.get_height(); j < je; ++j)
+            {
+                // Flip the image vertically (Maya is Y up).
+                float *dst = pixels.get() + ((height - 1 - (y0 + j)) * width + x0) * 4;
+
+                for(size_t i = 0, ie = tile.get_width(); i < ie; ++i)
+                {
+                    *dst++ = tile.get_component<float>(i, j, 0);
+                    *dst++ = tile.get_component<float>(i, j, 1);
+                    *dst++ = tile.get_component<float>(i, j, 2);
+                    *dst++ = tile.get_component<float>(i, j, 3);
+                }
+            }
+        }
+    }
+
+    // Upscale preview frames.
+    size_t displayWidth = width;
+    size_t displayHeight = height;
+    const size_t scale = m_factory.scale();
+
+    if (scale > 1)
+    {
+        displayWidth = m_factory.displayWidth();
+        displayHeight = m_factory.displayHeight();
+        boost::shared_array<float> displayPixels(new float[displayWidth * displayHeight * 4]);
+
+        for(size_t j = 0; j < displayHeight; ++j)
+        {
+            const float *srcRow = pixels.get() + std::min(j / scale, height - 1) * width * 4;
+            float *dst = displayPixels.get() + j * displayWidth * 4;
+
+            for(size_t i = 0; i < displayWidth; ++i, dst += 4)
+            {
+                const float *src = srcRow + std::min(i / scale, width - 1) * 4;
+                std::copy(src, src + 4, dst);
+            }
+        }
+
+        pixels.swap(displayPixels);
+    }
+
+    MPxRenderer::RefreshParams params;
+    params.width = static_cast<unsigned int>(displayWidth);
+    params.height = static_cast<unsigned int>(displayHeight);
+    params.left = 0;
+    params.right = params.width - 1;
+    params.bottom = 0;
+    params.top = params.height - 1;
+    params.channels = 4;
+    params.bytesPerChannel = sizeof(float);
+    params.data = pixels.get();
+    MPxRenderer::refresh(params);
+}
 
 const MString HypershadeRenderer::name("appleseed");
 
@@ -38,101 +326,634 @@ void* HypershadeRenderer::creator()
 }
 
 HypershadeRenderer::HypershadeRenderer()
+  : m_mainAssembly(0)
+  , m_isRunning(false)
+  , m_maxSamples(0)
+  , m_updateDepth(0)
+  , m_width(128)
+  , m_height(128)
+  , m_frameDirty(true)
+  , m_cameraDirty(true)
+  , m_environmentDirty(true)
+  , m_lightsDirty(false)
+  , m_shadersDirty(false)
+  , m_instancesDirty(false)
 {
+    m_tileCallbackFactory.reset(new HypershadeTileCallbackFactory());
+    createProject();
+}
+
+HypershadeRenderer::~HypershadeRenderer()
+{
+    stopRendering();
+    m_networkExporters.clear();
+    m_renderer.reset();
 }
 
 bool HypershadeRenderer::isSafeToUnload()
 {
-    return true;
+    return !m_isRunning;
 }
 
 MStatus HypershadeRenderer::startAsync(const JobParams& params)
 {
+    m_isRunning = true;
+    m_maxSamples = params.maxSamples;
+
+    if (m_updateDepth == 0)
+        startRendering();
+
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::stopAsync()
 {
+    m_isRunning = false;
+    stopRendering();
     return MS::kSuccess;
 }
 
 bool HypershadeRenderer::isRunningAsync()
 {
-    return true;
+    return m_isRunning;
 }
 
 MStatus HypershadeRenderer::beginSceneUpdate()
 {
+    // The project can't be edited while the renderer is running.
+    // Only sampling is stopped; the scene is kept and updated incrementally.
+    if (m_updateDepth++ == 0)
+        stopRendering();
+
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::endSceneUpdate()
 {
+    if (m_updateDepth == 0 || --m_updateDepth != 0)
+        return MS::kSuccess;
+
+    updateFrame();
+    updateEnvironment();
+    updateCamera();
+    updateLights();
+    updateMeshes();
+    updateShaders();
+    updateInstances();
+
+    // Restart sampling.
+    if (m_isRunning)
+        startRendering();
+
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::destroyScene()
 {
+    stopRendering();
+
+    m_networkExporters.clear();
+    m_renderer.reset();
+    m_project.reset();
+
+    m_meshes.clear();
+    m_lights.clear();
+    m_cameras.clear();
+    m_shaders.clear();
+    m_assignments.clear();
+    m_transforms.clear();
+    m_dirtyMeshes.clear();
+    m_dirtyShaders.clear();
+
+    createProject();
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::setProperty(const MUuid& id, const MString& name, bool value)
 {
+    propertyChanged(id);
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::setProperty(const MUuid& id, const MString& name, int value)
 {
+    propertyChanged(id);
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::setProperty(const MUuid& id, const MString& name, float value)
 {
+    propertyChanged(id);
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::setProperty(const MUuid& id, const MString& name, const MString& value)
 {
+    propertyChanged(id);
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::setShader(const MUuid& id, const MUuid& shaderId)
 {
+    m_assignments[id.asString()] = shaderId.asString();
+    m_shadersDirty = true;
+    m_instancesDirty = true;
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::setResolution(unsigned int w, unsigned int h)
 {
+    if (w != m_width || h != m_height)
+    {
+        m_width = w;
+        m_height = h;
+        m_frameDirty = true;
+        m_cameraDirty = true;
+    }
+
     return MS::kSuccess;
 }
 
-
 MStatus HypershadeRenderer::translateMesh(const MUuid& id, const MObject& node)
 {
+    const MString meshId = id.asString();
+    m_meshes[meshId] = node;
+    m_dirtyMeshes.push_back(meshId);
+    m_instancesDirty = true;
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::translateLightSource(const MUuid& id, const MObject& node)
 {
+    m_lights[id.asString()] = node;
+    m_lightsDirty = true;
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::translateCamera(const MUuid& id, const MObject& node)
 {
+    m_cameras[id.asString()] = node;
+    m_cameraDirty = true;
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::translateEnvironment(const MUuid& id, EnvironmentType type)
 {
+    m_environmentDirty = true;
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::translateTransform(const MUuid& id, const MUuid& childId, const MMatrix& matrix)
 {
+    const MString childName = childId.asString();
+    m_transforms[childName] = matrix;
+
+    if (m_meshes.count(childName) != 0)
+        m_instancesDirty = true;
+    else if (m_lights.count(childName) != 0)
+        m_lightsDirty = true;
+    else if (m_cameras.count(childName) != 0)
+        m_cameraDirty = true;
+
     return MS::kSuccess;
 }
 
 MStatus HypershadeRenderer::translateShader(const MUuid& id, const MObject& node)
 {
+    m_shaders[id.asString()] = node;
+    m_shadersDirty = true;
     return MS::kSuccess;
 }
+
+void HypershadeRenderer::createProject()
+{
+    m_project = asr::ProjectFactory::create("hypershade");
+    m_project->add_default_configurations();
+
+    asr::ParamArray& params =
+        m_project->configurations().get_by_name("interactive")->get_parameters();
+    params.insert("sample_renderer", "generic");
+    params.insert("sample_generator", "generic");
+    params.insert("tile_renderer", "generic");
+    params.insert("frame_renderer", "progressive");
+    params.insert("lighting_engine", "pt");
+    params.insert("pixel_renderer", "uniform");
+    params.insert("sampling_mode", "qmc");
+
+    m_project->set_scene(asr::SceneFactory::create());
+
+    asf::auto_release_ptr<asr::Assembly> assembly(
+        asr::AssemblyFactory().create("assembly", asr::ParamArray()));
+    m_mainAssembly = assembly.get();
+    m_project->get_scene()->assemblies().insert(assembly);
+
+    asf::auto_release_ptr<asr::AssemblyInstance> assemblyInstance(
+        asr::AssemblyInstanceFactory::create("assembly_inst", asr::ParamArray(), "assembly"));
+    m_project->get_scene()->assembly_instances().insert(assemblyInstance);
+
+    m_frameDirty = true;
+    m_cameraDirty = true;
+    m_environmentDirty = true;
+    m_lightsDirty = true;
+    m_shadersDirty = true;
+    m_instancesDirty = true;
+}
+
+void HypershadeRenderer::startRendering()
+{
+    if (m_project->get_frame() == 0)
+        return;
+
+    // The renderer is kept between scene updates.
+    if (!m_renderer)
+    {
+        m_renderer.reset(
+            new asr::MasterRenderer(
+                m_project.ref(),
+                m_project->configurations().get_by_name("interactive")->get_inherited_parameters(),
+                &m_rendererController,
+                m_tileCallbackFactory.get()));
+    }
+
+    if (m_maxSamples != 0)
+        m_renderer->get_parameters().insert_path("progressive_frame_renderer.max_samples", m_maxSamples);
+
+    m_rendererController.set_status(asr::IRendererController::ContinueRendering);
+    m_renderThread = boost::thread(boost::bind(&HypershadeRenderer::renderFunc, this));
+}
+
+void HypershadeRenderer::stopRendering()
+{
+    if (m_renderThread.joinable())
+    {
+        m_rendererController.set_status(asr::IRendererController::AbortRendering);
+        m_renderThread.join();
+    }
+}
+
+void HypershadeRenderer::renderFunc()
+{
+    // Disable logging while rendering.
+    ScopedSetLoggerVerbosity logLevel(asf::LogMessage::Error);
+
+    // Render one sample per pixel of low resolution preview frames first,
+    // so that edits are visible quickly, then refine at full resolution.
+    const asr::ParamArray params = m_renderer->get_parameters();
+    bool aborted = false;
+
+    for(size_t scale = MaxPreviewScale; scale > 1 && !aborted; scale /= 2)
+    {
+        const size_t width = m_width / scale;
+        const size_t height = m_height / scale;
+
+        if (width < MinPreviewSize || height < MinPreviewSize)
+            continue;
+
+        setFrame(width, height);
+        m_tileCallbackFactory->setDisplay(m_width, m_height, scale);
+        m_renderer->get_parameters().insert_path("progressive_frame_renderer.max_samples", width * height);
+        m_renderer->render();
+
+        aborted = m_rendererController.get_status() == asr::IRendererController::AbortRendering;
+    }
+
+    setFrame(m_width, m_height);
+    m_tileCallbackFactory->setDisplay(m_width, m_height, 1);
+    m_renderer->get_parameters() = params;
+
+    if (!aborted)
+        m_renderer->render();
+}
+
+void HypershadeRenderer::propertyChanged(const MUuid& id)
+{
+    const MString name = id.asString();
+
+    if (m_meshes.count(name) != 0)
+    {
+        m_dirtyMeshes.push_back(name);
+        m_instancesDirty = true;
+    }
+    else if (m_lights.count(name) != 0)
+        m_lightsDirty = true;
+    else if (m_cameras.count(name) != 0)
+        m_cameraDirty = true;
+    else if (m_shaders.count(name) != 0)
+    {
+        // Only re-export the assigned networks the node is part of.
+        const MString nodeName = MFnDependencyNode(m_shaders[name]).name();
+
+        for(NetworkExporterMap::const_iterator it = m_networkExporters.begin(), e = m_networkExporters.end();
+            it != e; ++it)
+        {
+            if (it->second->containsNode(nodeName) &&
+                std::find(m_dirtyShaders.begin(), m_dirtyShaders.end(), it->first) == m_dirtyShaders.end())
+            {
+                m_dirtyShaders.push_back(it->first);
+            }
+        }
+    }
+    else
+    {
+        // Unknown node, re-export all the assigned networks.
+        m_shadersDirty = true;
+    }
+}
+
+void HypershadeRenderer::updateFrame()
+{
+    if (!m_frameDirty)
+        return;
+
+    setFrame(m_width, m_height);
+    m_frameDirty = false;
+}
+
+void HypershadeRenderer::setFrame(const size_t width, const size_t height)
+{
+    asf::auto_release_ptr<asr::Frame> frame(
+        asr::FrameFactory::create(
+            "beauty",
+            asr::ParamArray()
+                .insert("resolution", asf::Vector2i(static_cast<int>(width), static_cast<int>(height)))
+                .insert("camera", CameraName)
+                .insert("pixel_format", "float")
+                .insert("color_space", "linear_rgb")
+                .insert("tile_size", asf::Vector2i(32, 32))));
+    m_project->set_frame(frame);
+}
+
+void HypershadeRenderer::updateEnvironment()
+{
+    if (!m_environmentDirty)
+        return;
+
+    asr::Scene *scene = m_project->get_scene();
+
+    if (scene->environment_edfs().get_by_name("environmentEDF") == 0)
+    {
+        asf::auto_release_ptr<asr::EnvironmentEDF> environmentEDF(
+            asr::ConstantEnvironmentEDFFactory().create(
+                "environmentEDF",
+                asr::ParamArray().insert("radiance", "0.2")));
+        scene->environment_edfs().insert(environmentEDF);
+
+        asf::auto_release_ptr<asr::EnvironmentShader> environmentShader(
+            asr::EDFEnvironmentShaderFactory().create(
+                "environmentShader",
+                asr::ParamArray()
+                    .insert("environment_edf", "environmentEDF")
+                    .insert("alpha_value", "1.0")));
+        scene->environment_shaders().insert(environmentShader);
+
+        asf::auto_release_ptr<asr::Environment> environment(
+            asr::EnvironmentFactory().create(
+                "environment",
+                asr::ParamArray().insert("environment_shader", "environmentShader")));
+        scene->set_environment(environment);
+    }
+
+    m_environmentDirty = false;
+}
+
+void HypershadeRenderer::updateCamera()
+{
+    if (!m_cameraDirty)
+        return;
+
+    asr::Scene *scene = m_project->get_scene();
+    removeEntity<asr::Camera>(scene->cameras(), CameraName);
+
+    asr::ParamArray cameraParams;
+    asf::Transformd xform(asf::Transformd::make_identity());
+
+    if (!m_cameras.empty())
+    {
+        MFnCamera cameraFn(m_cameras.begin()->second);
+
+        // Maya's aperture is given in inches so convert to cm and then to meters.
+        float horizontalFilmAperture = cameraFn.horizontalFilmAperture() * 2.54f * 0.01f;
+        float verticalFilmAperture = cameraFn.verticalFilmAperture() * 2.54f * 0.01f;
+
+        // Fit the film to the image, horizontally.
+        const float imageAspect = static_cast<float>(m_width) / m_height;
+        verticalFilmAperture = horizontalFilmAperture / imageAspect;
+
+        cameraParams.insert(
+            "film_dimensions",
+            asf::Vector2f(horizontalFilmAperture, verticalFilmAperture));
+
+        // Maya's focal length is given in mm so we convert it to meters.
+        cameraParams.insert("focal_length", cameraFn.focalLength() * 0.001f);
+
+        xform = convertTransform(transform(m_cameras.begin()->first));
+    }
+    else
+    {
+        cameraParams.insert("film_dimensions", "0.0359999 0.0359999");
+        cameraParams.insert("focal_length", "0.035");
+        xform = asf::Transformd(asf::Matrix4d::make_translation(asf::Vector3d(0.0, 0.0, 2.65)));
+    }
+
+    asf::auto_release_ptr<asr::Camera> camera(
+        asr::PinholeCameraFactory().create(CameraName, cameraParams));
+    camera->transform_sequence().set_transform(0.0f, xform);
+    scene->cameras().insert(camera);
+
+    m_cameraDirty = false;
+}
+
+void HypershadeRenderer::updateLights()
+{
+    if (!m_lightsDirty)
+        return;
+
+    m_mainAssembly->lights().clear();
+    m_mainAssembly->colors().clear();
+
+    asr::LightFactoryRegistrar lightFactories;
+
+    for(NodeMap::const_iterator it = m_lights.begin(), e = m_lights.end(); it != e; ++it)
+    {
+        MFnDependencyNode depNodeFn(it->second);
+
+        float intensity = 1.0f;
+        AttributeUtils::get(depNodeFn, "intensity", intensity);
+
+        MColor color(1.0f, 1.0f, 1.0f);
+        AttributeUtils::get(depNodeFn, "color", color);
+
+        const MString colorName = it->first + MString("_intensity_color");
+        asr::ColorValueArray values(3, &color.r);
+        m_mainAssembly->colors().insert(
+            asr::ColorEntityFactory::create(
+                colorName.asChar(),
+                asr::ParamArray().insert("color_space", "linear_rgb"),
+                values));
+
+        const asr::ILightFactory *lightFactory = 0;
+        asr::ParamArray lightParams;
+
+        if (depNodeFn.typeName() == "directionalLight")
+        {
+            lightFactory = lightFactories.lookup("directional_light");
+            lightParams.insert("irradiance", colorName.asChar());
+            lightParams.insert("irradiance_multiplier", intensity);
+        }
+        else if (depNodeFn.typeName() == "pointLight")
+        {
+            lightFactory = lightFactories.lookup("point_light");
+            lightParams.insert("intensity", colorName.asChar());
+            lightParams.insert("intensity_multiplier", intensity);
+        }
+        else if (depNodeFn.typeName() == "spotLight")
+        {
+            lightFactory = lightFactories.lookup("spot_light");
+            lightParams.insert("intensity", colorName.asChar());
+            lightParams.insert("intensity_multiplier", intensity);
+
+            double coneAngle = 40.0;
+            AttributeUtils::get(depNodeFn, "coneAngle", coneAngle);
+            lightParams.insert("inner_angle", asf::rad_to_deg(coneAngle));
+            lightParams.insert("outer_angle", asf::rad_to_deg(coneAngle));
+        }
+        else
+        {
+            RENDERER_LOG_DEBUG(
+                "Skipping unsupported hypershade light type %s.",
+                depNodeFn.typeName().asChar());
+            continue;
+        }
+
+        asf::auto_release_ptr<asr::Light> light(
+            lightFactory->create(it->first.asChar(), lightParams));
+        light->set_transform(convertTransform(transform(it->first)));
+        m_mainAssembly->lights().insert(light);
+    }
+
+    m_lightsDirty = false;
+}
+
+void HypershadeRenderer::updateMeshes()
+{
+    for(size_t i = 0, e = m_dirtyMeshes.size(); i < e; ++i)
+    {
+        const MString& meshId = m_dirtyMeshes[i];
+
+        NodeMap::const_iterator it = m_meshes.find(meshId);
+        if (it == m_meshes.end())
+            continue;
+
+        removeEntity<asr::Object>(m_mainAssembly->objects(), meshId);
+
+        asf::auto_release_ptr<asr::MeshObject> mesh = convertMesh(meshId, it->second);
+        m_mainAssembly->objects().insert(asf::auto_release_ptr<asr::Object>(mesh.release()));
+    }
+
+    m_dirtyMeshes.clear();
+}
+
+void HypershadeRenderer::updateShaders()
+{
+    if (m_shadersDirty)
+    {
+        // The exporters remove their shader groups when destroyed.
+        m_networkExporters.clear();
+        m_mainAssembly->materials().clear();
+
+        for(AssignmentMap::const_iterator it = m_assignments.begin(), e = m_assignments.end(); it != e; ++it)
+        {
+            const MString& shaderId = it->second;
+            const MString name = materialName(shaderId);
+
+            if (m_mainAssembly->materials().get_by_name(name.asChar()))
+                continue;
+
+            m_mainAssembly->materials().insert(
+                asr::OSLMaterialFactory().create(name.asChar(), asr::ParamArray()));
+            exportShadingNetwork(shaderId);
+        }
+
+        m_shadersDirty = false;
+    }
+    else
+    {
+        for(size_t i = 0, e = m_dirtyShaders.size(); i < e; ++i)
+            exportShadingNetwork(m_dirtyShaders[i]);
+    }
+
+    m_dirtyShaders.clear();
+}
+
+// Export the shading network of an assigned shader and connect it to its material.
+void HypershadeRenderer::exportShadingNetwork(const MString& shaderId)
+{
+    asr::Material* material =
+        m_mainAssembly->materials().get_by_name(materialName(shaderId).asChar());
+    if (material == 0)
+        return;
+
+    // Remove the previous shader group first, the new one has the same name.
+    m_networkExporters.erase(shaderId);
+    material->get_parameters().remove_path("osl_surface");
+
+    NodeMap::const_iterator shaderIt = m_shaders.find(shaderId);
+    MPlug outputPlug;
+    if (shaderIt == m_shaders.end() || !findSurfaceOutputPlug(shaderIt->second, outputPlug))
+        return;
+
+    ShadingNetworkExporterPtr exporter(
+        NodeExporterFactory::createShadingNetworkExporter(
+            SurfaceNetworkContext,
+            shaderIt->second,
+            outputPlug,
+            *m_mainAssembly,
+            AppleseedSession::ProgressiveRenderSession));
+
+    exporter->createEntities();
+    exporter->flushEntities();
+    m_networkExporters[shaderId] = exporter;
+
+    material->get_parameters().insert(
+        "osl_surface",
+        exporter->shaderGroupName().asChar());
+}
+
+void HypershadeRenderer::updateInstances()
+{
+    if (!m_instancesDirty)
+        return;
+
+    m_mainAssembly->object_instances().clear();
+
+    for(NodeMap::const_iterator it = m_meshes.begin(), e = m_meshes.end(); it != e; ++it)
+    {
+        asf::StringDictionary materials;
+
+        AssignmentMap::const_iterator assignmentIt = m_assignments.find(it->first);
+        if (assignmentIt != m_assignments.end())
+            materials.insert("default", materialName(assignmentIt->second).asChar());
+
+        const MString instanceName = it->first + MString("_instance");
+        asf::auto_release_ptr<asr::ObjectInstance> instance(
+            asr::ObjectInstanceFactory().create(
+                instanceName.asChar(),
+                asr::ParamArray(),
+                it->first.asChar(),
+                convertTransform(transform(it->first)),
+                materials,
+                materials));
+        m_mainAssembly->object_instances().insert(instance);
+    }
+
+    m_instancesDirty = false;
+}
+
+MMatrix HypershadeRenderer::transform(const MString& id) const
+{
+    TransformMap::const_iterator it = m_transforms.find(id);
+    if (it != m_transforms.end())
+        return it->second;
+
+    return MMatrix::identity;
+}
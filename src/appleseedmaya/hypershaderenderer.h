@@ -29,8 +29,44 @@
 #ifndef APPLESEED_MAYA_HYPERSHADE_RENDERER_H
 #define APPLESEED_MAYA_HYPERSHADE_RENDERER_H
 
+// Standard headers.
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// Boost headers.
+#include "boost/scoped_ptr.hpp"
+#include "boost/thread/thread.hpp"
+
 // Maya headers.
+#include <maya/MMatrix.h>
+#include <maya/MObject.h>
 #include <maya/MPxRenderer.h>
+#include <maya/MString.h>
+
+// appleseed.foundation headers.
+#include "foundation/utility/autoreleaseptr.h"
+
+// appleseed.maya headers.
+#include "appleseedmaya/exporters/shadingnetworkexporterfwd.h"
+#include "appleseedmaya/renderercontroller.h"
+#include "appleseedmaya/utils.h"
+
+// Forward declarations.
+class HypershadeTileCallbackFactory;
+namespace renderer { class Assembly; }
+namespace renderer { class MasterRenderer; }
+namespace renderer { class Project; }
+
+//
+// HypershadeRenderer.
+//
+//  Renders the Hypershade material viewer.
+//  Maya's scene translation calls are recorded and applied to a persistent
+//  appleseed project in endSceneUpdate, then the progressive frame renderer
+//  restarts sampling in a background thread, with low resolution previews
+//  followed by the full resolution frame.
+//
 
 class HypershadeRenderer
   : public MPxRenderer
@@ -41,6 +77,7 @@ class HypershadeRenderer
     static void* creator();
 
     HypershadeRenderer();
+    ~HypershadeRenderer();
 
     virtual bool isSafeToUnload();
 
@@ -66,6 +103,64 @@ class HypershadeRenderer
     virtual MStatus translateEnvironment(const MUuid& id, EnvironmentType type);
     virtual MStatus translateTransform(const MUuid& id, const MUuid& childId, const MMatrix& matrix);
     virtual MStatus translateShader(const MUuid& id, const MObject& node);
+
+  private:
+    typedef std::map<MString, MObject, MStringCompareLess> NodeMap;
+    typedef std::map<MString, MString, MStringCompareLess> AssignmentMap;
+    typedef std::map<MString, MMatrix, MStringCompareLess> TransformMap;
+    typedef std::map<MString, ShadingNetworkExporterPtr, MStringCompareLess> NetworkExporterMap;
+
+    void createProject();
+
+    void startRendering();
+    void stopRendering();
+    void renderFunc();
+
+    void propertyChanged(const MUuid& id);
+
+    void updateFrame();
+    void setFrame(const size_t width, const size_t height);
+    void updateCamera();
+    void updateEnvironment();
+    void updateLights();
+    void updateMeshes();
+    void updateShaders();
+    void exportShadingNetwork(const MString& shaderId);
+    void updateInstances();
+
+    MMatrix transform(const MString& id) const;
+
+    foundation::auto_release_ptr<renderer::Project> m_project;
+    renderer::Assembly*                             m_mainAssembly;
+    foundation::auto_release_ptr<HypershadeTileCallbackFactory> m_tileCallbackFactory;
+    boost::scoped_ptr<renderer::MasterRenderer>     m_renderer;
+    RendererController                              m_rendererController;
+    boost::thread                                   m_renderThread;
+    bool                                            m_isRunning;
+    unsigned int                                    m_maxSamples;
+
+    int                                             m_updateDepth;
+    unsigned int                                    m_width;
+    unsigned int                                    m_height;
+
+    // Translated nodes, keyed by Maya's uuids.
+    NodeMap                                         m_meshes;
+    NodeMap                                         m_lights;
+    NodeMap                                         m_cameras;
+    NodeMap                                         m_shaders;
+    AssignmentMap                                   m_assignments;
+    TransformMap                                    m_transforms;
+    NetworkExporterMap                              m_networkExporters; // Keyed by assigned shader.
+
+    // Pending updates.
+    std::vector<MString>                            m_dirtyMeshes;
+    std::vector<MString>                            m_dirtyShaders;
+    bool                                            m_frameDirty;
+    bool                                            m_cameraDirty;
+    bool                                            m_environmentDirty;
+    bool                                            m_lightsDirty;
+    bool                                            m_shadersDirty;
+    bool                                            m_instancesDirty;
 };
 
 #endif  // !APPLESEED_MAYA_HYPERSHADE_RENDERER_H
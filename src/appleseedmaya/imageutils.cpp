@@ -29,6 +29,9 @@
 // Interface header.
 #include "appleseedmaya/imageutils.h"
 
+// Standard headers.
+#include <cstring>
+
 // Maya headers.
 #include <maya/MImage.h>
 
@@ -38,17 +41,45 @@
 
 namespace asf = foundation;
 
+namespace
+{
+
+// Copy RGBA 8 bit pixels to BGRA, swapping the red and blue channels.
+// Pixels are processed as 32 bit little endian words,
+// which lets the compiler vectorize the loop.
+void swizzleRGBAToBGRA(const uint8_t* src, uint8_t* dst, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t p;
+        memcpy(&p, src + i * 4, 4);
+        p = (p & 0xFF00FF00u) | ((p >> 16) & 0x000000FFu) | ((p & 0x000000FFu) << 16);
+        memcpy(dst + i * 4, &p, 4);
+    }
+}
+
+}
+
 namespace ImageUtils
 {
 
 void copySwatchImage(const asf::Image& srcImage, MImage& dstImage)
 {
-    const asf::CanvasProperties& props = srcImage.properties();
-
     unsigned int width;
     unsigned int height;
     dstImage.getSize(width, height);
 
+    copySwatchImage(srcImage, dstImage.pixels(), width, height);
+}
+
+void copySwatchImage(
+    const asf::Image&   srcImage,
+    unsigned char*      dstPixels,
+    const size_t        width,
+    const size_t        height)
+{
+    const asf::CanvasProperties& props = srcImage.properties();
+
     assert(props.m_canvas_width == width);
     assert(props.m_canvas_height == height);
     // ...
@@ -64,22 +95,16 @@ void copySwatchImage(const asf::Image& srcImage, MImage& dstImage)
 
             const asf::Tile& tile = srcImage.tile(tx, ty);
             const uint8_t *src = tile.get_storage();
+            const size_t tileWidth = tile.get_width();
 
             for (size_t j = 0, je = tile.get_height(); j < je; ++j)
             {
                 // For swatches, we assume 4 8 bit channels.
+                // Maya docs say RGBA, but it is actually BGRA?.
                 const size_t y = y0 + j;
-                uint8_t *dst = dstImage.pixels() + (y * width * 4) + (x0 * 4);
-
-                for (size_t i = 0, ie = tile.get_width(); i < ie; ++i)
-                {
-                    // Maya docs say RGBA, but it is actually BGRA?.
-                    *dst++ = src[2];
-                    *dst++ = src[1];
-                    *dst++ = src[0];
-                    *dst++ = src[3];
-                    src += 4;
-                }
+                uint8_t *dst = dstPixels + (y * width * 4) + (x0 * 4);
+                swizzleRGBAToBGRA(src, dst, tileWidth);
+                src += tileWidth * 4;
             }
         }
     }
@@ -29,6 +29,9 @@
 #ifndef APPLESEED_MAYA_IMAGEUTILS_H
 #define APPLESEED_MAYA_IMAGEUTILS_H
 
+// Standard headers.
+#include <cstddef>
+
 // Forward declarations.
 class MImage;
 namespace foundation { class Image; }
@@ -38,6 +41,13 @@ namespace ImageUtils
 
 void copySwatchImage(const foundation::Image& src, MImage& dst);
 
+// Copy a swatch image to a width x height 8 bit BGRA buffer.
+void copySwatchImage(
+    const foundation::Image&    src,
+    unsigned char*              dst,
+    const size_t                width,
+    const size_t                height);
+
 } // namespace ImageUtils.
 
 #endif  // !APPLESEED_MAYA_IMAGEUTILS_H
@@ -0,0 +1,189 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "appleseedmaya/meshutils.h"
+
+// Standard headers.
+#include <algorithm>
+#include <vector>
+
+// Maya headers.
+#include <maya/MFloatArray.h>
+#include <maya/MFnMesh.h>
+#include <maya/MIntArray.h>
+#include <maya/MItMeshPolygon.h>
+#include <maya/MObject.h>
+#include <maya/MPointArray.h>
+
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/object.h"
+
+namespace asf = foundation;
+namespace asr = renderer;
+
+namespace MeshUtils
+{
+
+void copyGeometry(const MObject& mesh, asr::MeshObject& dst)
+{
+    MStatus status;
+    MFnMesh meshFn(mesh);
+
+    // Vertices.
+    dst.reserve_vertices(meshFn.numVertices());
+    {
+        const float *p = meshFn.getRawPoints(&status);
+        for(int i = 0, e = meshFn.numVertices(); i < e; ++i, p += 3)
+            dst.push_vertex(asr::GVector3(p[0], p[1], p[2]));
+    }
+
+    if (meshFn.numUVs() != 0)
+    {
+        dst.reserve_tex_coords(meshFn.numUVs());
+        MFloatArray u, v;
+        status = meshFn.getUVs(u, v);
+        for(int i = 0, e = meshFn.numUVs(); i < e; ++i)
+            dst.push_tex_coords(asr::GVector2(u[i], v[i]));
+    }
+
+    if (meshFn.numNormals() != 0)
+    {
+        dst.reserve_vertex_normals(meshFn.numNormals());
+        const float *p = meshFn.getRawNormals(&status);
+
+        for(int i = 0, e = meshFn.numNormals(); i < e; ++i, p += 3)
+        {
+            asr::GVector3 n(p[0], p[1], p[2]);
+            dst.push_vertex_normal(asf::safe_normalize(n));
+        }
+    }
+}
+
+void copyTopology(
+    const MObject&          mesh,
+    const MIntArray&        perFaceMaterials,
+    asr::MeshObject&        dst)
+{
+    MStatus status;
+    MFnMesh meshFn(mesh);
+    const bool exportUVs = meshFn.numUVs() != 0;
+    const bool exportNormals = meshFn.numNormals() != 0;
+
+    // Triangle buffer.
+    std::vector<asr::Triangle> triangles;
+
+    MIntArray faceVertexIndices;
+    MIntArray faceUVIndices;
+    MIntArray faceNormalIndices;
+    MIntArray triangleVertexIndices;
+    MPointArray trianglePoints;
+
+    MItMeshPolygon faceIt(mesh);
+    for(; !faceIt.isDone(); faceIt.next())
+    {
+        // Get the material index for this face.
+        int materialIndex = 0;
+        if (perFaceMaterials.length() != 0)
+            materialIndex = perFaceMaterials[faceIt.index()];
+
+        // Collect normal and uv indices for this face.
+        faceUVIndices.clear();
+        faceNormalIndices.clear();
+
+        faceIt.getVertices(faceVertexIndices);
+        for(unsigned int i = 0, e = faceVertexIndices.length(); i < e; ++i)
+        {
+            if (exportUVs)
+            {
+                int uvIndex;
+                status = faceIt.getUVIndex(i, uvIndex);
+                faceUVIndices.append(uvIndex);
+            }
+
+            if (exportNormals)
+                faceNormalIndices.append(faceIt.normalIndex(i, &status));
+        }
+
+        // Match the triangle indices to the face indices.
+        int numTris;
+        faceIt.numTriangles(numTris);
+        for(int i = 0; i < numTris; ++i)
+        {
+            trianglePoints.clear();
+            triangleVertexIndices.clear();
+            faceIt.getTriangle(i, trianglePoints, triangleVertexIndices);
+
+            int triangleVertexOffset[3] = {-1, -1, -1};
+            for(unsigned int j = 0, je = faceVertexIndices.length(); j < je; ++j)
+            {
+                if (faceVertexIndices[j] == triangleVertexIndices[0])
+                    triangleVertexOffset[0] = j;
+                else if (faceVertexIndices[j] == triangleVertexIndices[1])
+                    triangleVertexOffset[1] = j;
+                else if (faceVertexIndices[j] == triangleVertexIndices[2])
+                    triangleVertexOffset[2] = j;
+            }
+
+            // Reverse the direction of the triangle.
+            std::swap(triangleVertexOffset[0], triangleVertexOffset[2]);
+
+            asr::Triangle triangle(
+                faceVertexIndices[triangleVertexOffset[0]],
+                faceVertexIndices[triangleVertexOffset[1]],
+                faceVertexIndices[triangleVertexOffset[2]],
+                materialIndex);
+
+            if (exportUVs)
+            {
+                triangle.m_a0 = faceUVIndices[triangleVertexOffset[0]];
+                triangle.m_a1 = faceUVIndices[triangleVertexOffset[1]];
+                triangle.m_a2 = faceUVIndices[triangleVertexOffset[2]];
+            }
+
+            if (exportNormals)
+            {
+                triangle.m_n0 = faceNormalIndices[triangleVertexOffset[0]];
+                triangle.m_n1 = faceNormalIndices[triangleVertexOffset[1]];
+                triangle.m_n2 = faceNormalIndices[triangleVertexOffset[2]];
+            }
+
+            triangles.push_back(triangle);
+        }
+    }
+
+    // Copy triangles to the mesh.
+    dst.reserve_triangles(triangles.size());
+    for(size_t i = 0, e = triangles.size(); i < e; ++i)
+        dst.push_triangle(triangles[i]);
+}
+
+} // namespace MeshUtils.
@@ -93,10 +93,10 @@ class MurmurHash
 
     void append(const foundation::StringDictionary& dictionary);
 
-  private:
-
     void append(const void *data, size_t bytes);
 
+  private:
+
     uint64_t m_h1;
     uint64_t m_h2;
 };
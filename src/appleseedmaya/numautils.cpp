@@ -0,0 +1,126 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "appleseedmaya/numautils.h"
+
+// Standard headers.
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+// POSIX headers.
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// Boost headers.
+#include "boost/filesystem/path.hpp"
+#include "boost/filesystem/operations.hpp"
+
+namespace bfs = boost::filesystem;
+
+namespace NumaUtils
+{
+
+std::vector<std::string> nodeCpuLists()
+{
+    std::vector<std::string> cpuLists;
+
+#ifdef __linux__
+    for (size_t i = 0; ; ++i)
+    {
+        std::stringstream ss;
+        ss << "/sys/devices/system/node/node" << i << "/cpulist";
+
+        boost::system::error_code ec;
+        if (!bfs::exists(ss.str(), ec))
+            break;
+
+        std::ifstream file(ss.str().c_str());
+        std::string cpuList;
+        if (!std::getline(file, cpuList))
+            break;
+
+        // Nodes without CPUs (memory only) have an empty list.
+        std::vector<size_t> cpus;
+        if (parseCpuList(cpuList, cpus) && !cpus.empty())
+            cpuLists.push_back(cpuList);
+    }
+#endif
+
+    return cpuLists;
+}
+
+bool parseCpuList(const std::string& cpuList, std::vector<size_t>& cpus)
+{
+    cpus.clear();
+
+    std::stringstream ss(cpuList);
+    std::string range;
+    while (std::getline(ss, range, ','))
+    {
+        if (range.empty() || range == "\n")
+            continue;
+
+        char* end;
+        const long first = std::strtol(range.c_str(), &end, 10);
+        long last = first;
+
+        if (*end == '-')
+            last = std::strtol(end + 1, &end, 10);
+
+        if ((*end != '\0' && *end != '\n') || first < 0 || last < first)
+            return false;
+
+        for (long cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(static_cast<size_t>(cpu));
+    }
+
+    return true;
+}
+
+bool setProcessAffinity(const std::vector<size_t>& cpus)
+{
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+
+    for (size_t i = 0, e = cpus.size(); i < e; ++i)
+    {
+        if (cpus[i] < CPU_SETSIZE)
+            CPU_SET(cpus[i], &cpuSet);
+    }
+
+    return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace NumaUtils.
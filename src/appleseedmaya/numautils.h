@@ -0,0 +1,62 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_MAYA_NUMA_UTILS_H
+#define APPLESEED_MAYA_NUMA_UTILS_H
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//
+// NUMA and CPU affinity utilities.
+//
+//  CPU lists use the Linux sysfs format, for example "0-7,16-23".
+//
+//  This file does not depend on Maya, it is also built into the
+//  appleseedMayaRender executable.
+//
+
+namespace NumaUtils
+{
+
+// Return the CPU list of each NUMA node of the machine.
+// Returns an empty vector if the topology is not available.
+std::vector<std::string> nodeCpuLists();
+
+// Parse a CPU list into CPU indices. Returns false if the list is malformed.
+bool parseCpuList(const std::string& cpuList, std::vector<size_t>& cpus);
+
+// Restrict the current process to the given CPUs.
+// Returns false on failure or if not supported on this platform.
+bool setProcessAffinity(const std::vector<size_t>& cpus);
+
+} // namespace NumaUtils.
+
+#endif  // !APPLESEED_MAYA_NUMA_UTILS_H
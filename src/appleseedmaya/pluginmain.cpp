@@ -34,6 +34,7 @@
 // appleseed.maya headers.
 #include "appleseedmaya/appleseedsession.h"
 #include "appleseedmaya/appleseedtranslator.h"
+#include "appleseedmaya/attributeutils.h"
 #include "appleseedmaya/config.h"
 #include "appleseedmaya/exporters/exporterfactory.h"
 #include "appleseedmaya/extensionAttributes.h"
@@ -42,6 +43,7 @@
 #include "appleseedmaya/rendercommands.h"
 #include "appleseedmaya/renderglobalsnode.h"
 #include "appleseedmaya/shadingnoderegistry.h"
+#include "appleseedmaya/shadingnodetemplatebuilder.h"
 #include "appleseedmaya/swatchrenderer.h"
 #if MAYA_API_VERSION >= 201600
     #include "appleseedmaya/hypershaderenderer.h"
@@ -139,6 +141,14 @@ APPLESEED_MAYA_PLUGIN_EXPORT MStatus initializePlugin(MObject plugin)
         status,
         "appleseedMaya: failed to register render command");
 
+    status = fnPlugin.registerCommand(
+        ShadingNodeTemplateCommand::cmdName,
+        ShadingNodeTemplateCommand::creator,
+        ShadingNodeTemplateCommand::syntaxCreator);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: failed to register shading node template command");
+
     status = addExtensionAttributes();
     APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
         status,
@@ -245,6 +255,8 @@ APPLESEED_MAYA_PLUGIN_EXPORT MStatus uninitializePlugin(MObject plugin)
         status,
         "appleseedMaya: failed to uninitialize node exporters factory");
 
+    AttributeUtils::clearAttributeCache();
+
 #if MAYA_API_VERSION >= 201600
     status = fnPlugin.deregisterRenderer(HypershadeRenderer::name);
     APPLESEED_MAYA_CHECK_MSTATUS_MSG(
@@ -266,6 +278,11 @@ APPLESEED_MAYA_PLUGIN_EXPORT MStatus uninitializePlugin(MObject plugin)
         status,
         "appleseedMaya: failed to deregister shading nodes");
 
+    status = fnPlugin.deregisterCommand(ShadingNodeTemplateCommand::cmdName);
+    APPLESEED_MAYA_CHECK_MSTATUS_MSG(
+        status,
+        "appleseedMaya: failed to deregister shading node template command");
+
     status = fnPlugin.deregisterCommand(FinalRenderCommand::cmdName);
     APPLESEED_MAYA_CHECK_MSTATUS_MSG(
         status,
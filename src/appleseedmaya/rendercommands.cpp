@@ -35,6 +35,7 @@
 // Maya headers.
 #include <maya/MArgDatabase.h>
 #include <maya/MCommonRenderSettingsData.h>
+#include <maya/MDoubleArray.h>
 #include <maya/MFnDependencyNode.h>
 #include <maya/MGlobal.h>
 #include <maya/MRenderUtil.h>
@@ -47,6 +48,7 @@
 #include "appleseedmaya/attributeutils.h"
 #include "appleseedmaya/config.h"
 #include "appleseedmaya/logger.h"
+#include "appleseedmaya/renderercontroller.h"
 #include "appleseedmaya/utils.h"
 
 MString FinalRenderCommand::cmdName("appleseedRender");
@@ -58,6 +60,7 @@ MSyntax FinalRenderCommand::syntaxCreator()
     syntax.addFlag("-w", "-width" , MSyntax::kLong);
     syntax.addFlag("-h", "-height", MSyntax::kLong);
     syntax.addFlag("-b", "-batch" , MSyntax::kString);
+    syntax.addFlag("-p", "-progress");
     return syntax;
 }
 
@@ -68,6 +71,28 @@ void* FinalRenderCommand::creator()
 
 MStatus FinalRenderCommand::doIt(const MArgList& args)
 {
+    MStatus status;
+    MArgDatabase argData(syntax(), args, &status);
+
+    // Query the progress of the current render, without interrupting it.
+    // Returns passes, tiles done, tile count, elapsed seconds and samples per second.
+    if (argData.isFlagSet("-progress", &status))
+    {
+        RenderProgress progress;
+        if (AppleseedSession::renderProgress(progress))
+        {
+            MDoubleArray result;
+            result.append(static_cast<double>(progress.m_passes));
+            result.append(static_cast<double>(progress.m_tilesDone));
+            result.append(static_cast<double>(progress.m_tileCount));
+            result.append(progress.m_elapsedTime);
+            result.append(progress.m_samplesPerSecond);
+            setResult(result);
+        }
+
+        return MS::kSuccess;
+    }
+
     std::cout << "Appleseed Render:\n";
     std::cout << "-----------------\n";
 
@@ -103,8 +128,6 @@ MStatus FinalRenderCommand::doIt(const MArgList& args)
 
     bool isBatch = false;
 
-    MStatus status;
-    MArgDatabase argData(syntax(), args, &status);
     if (argData.isFlagSet("-batch", &status))
     {
         isBatch = true;
@@ -160,6 +183,7 @@ MSyntax ProgressiveRenderCommand::syntaxCreator()
     syntax.addFlag("-w", "-width" , MSyntax::kLong);
     syntax.addFlag("-h", "-height", MSyntax::kLong);
     syntax.addFlag("-a", "-action" , MSyntax::kString);
+    syntax.addFlag("-p", "-pause" , MSyntax::kBoolean);
     return syntax;
 }
 
@@ -173,6 +197,23 @@ MStatus ProgressiveRenderCommand::doIt(const MArgList& args)
     // Maybe we should check and fail instead of asserting?
     //assert(MRenderView::doesRenderEditorExist());
 
+    MStatus status;
+    MArgDatabase argData(syntax(), args, &status);
+
+    MString action;
+    if (argData.isFlagSet("-action", &status))
+        status = argData.getFlagArgument("-action", 0, action);
+
+    if (action == "pause")
+    {
+        bool pause = true;
+        if (argData.isFlagSet("-pause", &status))
+            status = argData.getFlagArgument("-pause", 0, pause);
+
+        AppleseedSession::pauseRender(pause);
+        return MS::kSuccess;
+    }
+
     /*
     std::cout << "Appleseed IPR:\n";
     std::cout << "--------------\n";
@@ -29,31 +29,157 @@
 #ifndef APPLESEED_MAYA_RENDERER_CONTROLLER_H
 #define APPLESEED_MAYA_RENDERER_CONTROLLER_H
 
+// Standard headers.
+#include <cstddef>
+
+// Boost headers.
+#include "boost/atomic.hpp"
+#include "boost/cstdint.hpp"
+
+// appleseed.foundation headers.
+#include "foundation/platform/defaulttimers.h"
+
 // appleseed.renderer headers.
 #include "renderer/api/rendering.h"
 
+// Rendering progress, as returned by RendererController::get_progress().
+struct RenderProgress
+{
+    size_t  m_passes;           // Completed passes.
+    size_t  m_tilesDone;        // Tiles rendered in the current pass.
+    size_t  m_tileCount;        // Tiles per pass, 0 if unknown.
+    double  m_elapsedTime;      // Seconds since rendering started.
+    double  m_samplesPerSecond; // Camera samples per second.
+};
+
+//
+// Renderer controller shared by the Maya thread, the render threads and
+// the tile callbacks. The status and the progress counters are atomic,
+// so that they can be polled from any thread without locking.
+//
+
 class RendererController
   : public renderer::DefaultRendererController
 {
   public:
 
     RendererController()
+      : m_status(ContinueRendering)
+      , m_tileCount(0)
+      , m_samplesPerPixel(1)
+      , m_timeLimit(0)
     {
-        m_status = ContinueRendering;
+        restart_progress();
     }
 
+    // Rendering is terminated, keeping the rendered frame, once the time limit is reached.
     virtual Status get_status() const
     {
-        return m_status;
+        const Status status = m_status.load(boost::memory_order_acquire);
+
+        if (status == ContinueRendering && time_limit_reached())
+            return TerminateRendering;
+
+        return status;
     }
 
     void set_status(Status status)
     {
-        m_status = status;
+        m_status.store(status, boost::memory_order_release);
+    }
+
+    // Pause rendering. Does nothing if rendering is being aborted or restarted.
+    void pause_rendering()
+    {
+        Status expected = ContinueRendering;
+        m_status.compare_exchange_strong(expected, PauseRendering);
+    }
+
+    // Resume a paused rendering.
+    void resume_rendering()
+    {
+        Status expected = PauseRendering;
+        m_status.compare_exchange_strong(expected, ContinueRendering);
+    }
+
+    // Limit the rendering time, in seconds since the last call to reset_progress().
+    // 0 disables the limit.
+    void set_time_limit(const double seconds)
+    {
+        m_timeLimit.store(
+            static_cast<boost::uint64_t>(seconds * m_timer.frequency()),
+            boost::memory_order_relaxed);
+    }
+
+    bool time_limit_reached() const
+    {
+        const boost::uint64_t limit = m_timeLimit.load(boost::memory_order_relaxed);
+        return limit != 0 && m_timer.read() - m_startTime.load(boost::memory_order_relaxed) >= limit;
+    }
+
+    // Reset the progress counters. Used to compute the tile count and samples per second.
+    void reset_progress(const size_t tileCount, const size_t samplesPerPixel)
+    {
+        m_tileCount.store(tileCount, boost::memory_order_relaxed);
+        m_samplesPerPixel.store(samplesPerPixel, boost::memory_order_relaxed);
+        restart_progress();
+    }
+
+    // Called by tile callbacks when a tile is rendered.
+    void on_tile_rendered(const size_t pixelCount)
+    {
+        m_tilesDone.fetch_add(1, boost::memory_order_relaxed);
+        m_pixelsDone.fetch_add(pixelCount, boost::memory_order_relaxed);
+    }
+
+    // Called by tile callbacks when a pass is rendered. Progressive renders
+    // don't report tiles, count the pixels of the whole pass in that case.
+    void on_pass_rendered(const size_t pixelCount)
+    {
+        if (m_tilesDone.exchange(0, boost::memory_order_relaxed) == 0)
+            m_pixelsDone.fetch_add(pixelCount, boost::memory_order_relaxed);
+
+        m_passes.fetch_add(1, boost::memory_order_relaxed);
+    }
+
+    RenderProgress get_progress() const
+    {
+        const boost::uint64_t ticks = m_timer.read() - m_startTime.load(boost::memory_order_relaxed);
+        const double elapsed = static_cast<double>(ticks) / m_timer.frequency();
+
+        RenderProgress progress;
+        progress.m_passes = m_passes.load(boost::memory_order_relaxed);
+        progress.m_tilesDone = m_tilesDone.load(boost::memory_order_relaxed);
+        progress.m_tileCount = m_tileCount.load(boost::memory_order_relaxed);
+        progress.m_elapsedTime = elapsed;
+        progress.m_samplesPerSecond =
+            elapsed > 0.0
+                ? static_cast<double>(m_pixelsDone.load(boost::memory_order_relaxed)) *
+                  m_samplesPerPixel.load(boost::memory_order_relaxed) / elapsed
+                : 0.0;
+
+        return progress;
     }
 
   private:
-    Status m_status;
+    void restart_progress()
+    {
+        m_passes.store(0, boost::memory_order_relaxed);
+        m_tilesDone.store(0, boost::memory_order_relaxed);
+        m_pixelsDone.store(0, boost::memory_order_relaxed);
+        m_startTime.store(m_timer.read(), boost::memory_order_relaxed);
+    }
+
+    boost::atomic<Status>                       m_status;
+
+    mutable foundation::DefaultWallclockTimer   m_timer;
+    boost::atomic<boost::uint64_t>              m_startTime;
+    boost::atomic<size_t>                       m_passes;
+    boost::atomic<size_t>                       m_tilesDone;
+    boost::atomic<size_t>                       m_tileCount;
+    boost::atomic<boost::uint64_t>              m_pixelsDone;
+    boost::atomic<size_t>                       m_samplesPerPixel;
+    boost::atomic<boost::uint64_t>              m_timeLimit;        // Timer ticks, 0 if not limited.
 };
 
 #endif  // !APPLESEED_MAYA_RENDERER_CONTROLLER_H
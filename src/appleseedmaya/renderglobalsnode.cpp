@@ -29,6 +29,10 @@
 // Interface header.
 #include "appleseedmaya/renderglobalsnode.h"
 
+// Standard headers.
+#include <algorithm>
+#include <cmath>
+
 // Maya headers.
 #include <maya/MFnDependencyNode.h>
 #include <maya/MFnEnumAttribute.h>
@@ -36,6 +40,7 @@
 #include <maya/MFnNumericAttribute.h>
 
 // appleseed.foundation headers.
+#include "foundation/math/scalar.h"
 #include "foundation/utility/api/specializedapiarrays.h"
 
 // appleseed.renderer headers.
@@ -51,12 +56,33 @@
 namespace asf = foundation;
 namespace asr = renderer;
 
+namespace
+{
+
+// Passes of time limited renders. Rendering stops before they are all rendered.
+const int MaxTimeLimitPasses = 1000000;
+
+} // unnamed.
+
 const MString RenderGlobalsNode::nodeName("appleseedRenderGlobals");
 const MTypeId RenderGlobalsNode::id(RenderGlobalsNodeTypeId);
 
 MObject RenderGlobalsNode::m_pixelSamples;
 MObject RenderGlobalsNode::m_passes;
+MObject RenderGlobalsNode::m_renderMode;
+MObject RenderGlobalsNode::m_timeLimit;
+MObject RenderGlobalsNode::m_noiseThreshold;
+MObject RenderGlobalsNode::m_minPixelSamples;
 MObject RenderGlobalsNode::m_tileSize;
+MObject RenderGlobalsNode::m_tileOrdering;
+MObject RenderGlobalsNode::m_pixelFormat;
+MObject RenderGlobalsNode::m_renderViewTransform;
+MObject RenderGlobalsNode::m_renderViewExposure;
+MObject RenderGlobalsNode::m_priorityRegion;
+MObject RenderGlobalsNode::m_priorityRegionLeft;
+MObject RenderGlobalsNode::m_priorityRegionRight;
+MObject RenderGlobalsNode::m_priorityRegionBottom;
+MObject RenderGlobalsNode::m_priorityRegionTop;
 
 MStringArray RenderGlobalsNode::m_diagnosticShaderKeys;
 MObject RenderGlobalsNode::m_diagnosticShader;
@@ -72,6 +98,26 @@ MObject RenderGlobalsNode::m_backgroundEmitsLight;
 MObject RenderGlobalsNode::m_envLightNode;
 
 MObject RenderGlobalsNode::m_renderingThreads;
+MObject RenderGlobalsNode::m_outOfProcess;
+MObject RenderGlobalsNode::m_processPriority;
+MObject RenderGlobalsNode::m_batchMode;
+MObject RenderGlobalsNode::m_batchProcesses;
+MObject RenderGlobalsNode::m_batchProcessThreads;
+MObject RenderGlobalsNode::m_distributeFrame;
+MObject RenderGlobalsNode::m_frameWorkers;
+MObject RenderGlobalsNode::m_checkpoint;
+MObject RenderGlobalsNode::m_checkpointInterval;
+MObject RenderGlobalsNode::m_resumeCheckpoint;
+
+MObject RenderGlobalsNode::m_diffuseAOV;
+MObject RenderGlobalsNode::m_glossyAOV;
+MObject RenderGlobalsNode::m_emissionAOV;
+MObject RenderGlobalsNode::m_depthAOV;
+MObject RenderGlobalsNode::m_normalAOV;
+MObject RenderGlobalsNode::m_albedoAOV;
+
+MObject RenderGlobalsNode::m_exrCompression;
+MObject RenderGlobalsNode::m_exrTiled;
 
 MObject RenderGlobalsNode::m_imageFormat;
 
@@ -83,6 +129,7 @@ void* RenderGlobalsNode::creator()
 MStatus RenderGlobalsNode::initialize()
 {
     MFnNumericAttribute numAttrFn;
+    MFnEnumAttribute enumAttrFn;
     MFnMessageAttribute msgAttrFn;
 
     MStatus status;
@@ -111,20 +158,71 @@ MStatus RenderGlobalsNode::initialize()
         status,
         "appleseedMaya: Failed to add render globals passes attribute");
 
-    // Tile Size.
+    // Final render mode.
+    m_renderMode = enumAttrFn.create("renderMode", "renderMode", 0, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals renderMode attribute");
+
+    enumAttrFn.addField("Fixed Samples", 0);
+    enumAttrFn.addField("Time Limit", 1);
+    enumAttrFn.addField("Noise Threshold", 2);
+
+    status = addAttribute(m_renderMode);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals renderMode attribute");
+
+    // Time limit per frame, in seconds.
+    m_timeLimit = numAttrFn.create("timeLimit", "timeLimit", MFnNumericData::kInt, 300, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals timeLimit attribute");
+
+    numAttrFn.setMin(1);
+    status = addAttribute(m_timeLimit);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals timeLimit attribute");
+
+    // Maximum pixel noise of adaptive sampling.
+    m_noiseThreshold = numAttrFn.create("noiseThreshold", "noiseThreshold", MFnNumericData::kFloat, 0.01f, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals noiseThreshold attribute");
+
+    numAttrFn.setMin(0.0001f);
+    numAttrFn.setMax(1.0f);
+    status = addAttribute(m_noiseThreshold);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals noiseThreshold attribute");
+
+    // Minimum pixel samples of adaptive sampling.
+    m_minPixelSamples = numAttrFn.create("minSamples", "minSamples", MFnNumericData::kInt, 4, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals minSamples attribute");
+
+    numAttrFn.setMin(1);
+    status = addAttribute(m_minPixelSamples);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals minSamples attribute");
+
+    // Tile Size (0 = auto).
     m_tileSize = numAttrFn.create("tileSize", "tileSize", MFnNumericData::kInt, 64, &status);
     APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
         status,
         "appleseedMaya: Failed to create render globals tileSize attribute");
 
-    numAttrFn.setMin(1);
+    numAttrFn.setMin(0);
     status = addAttribute(m_tileSize);
     APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
         status,
         "appleseedMaya: Failed to add render globals tileSize attribute");
 
     // Diagnostic shader override.
-    MFnEnumAttribute enumAttrFn;
     m_diagnosticShader = enumAttrFn.create("diagnostics", "diagnostics", 0, &status);
     APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
         status,
@@ -155,6 +253,125 @@ MStatus RenderGlobalsNode::initialize()
         status,
         "appleseedMaya: Failed to add render globals diagnostic shader attribute");
 
+    // Tile Ordering.
+    m_tileOrdering = enumAttrFn.create("tileOrdering", "tileOrdering", 1, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals tileOrdering attribute");
+
+    enumAttrFn.addField("Linear", 0);
+    enumAttrFn.addField("Spiral", 1);
+    enumAttrFn.addField("Hilbert", 2);
+    enumAttrFn.addField("Random", 3);
+
+    status = addAttribute(m_tileOrdering);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals tileOrdering attribute");
+
+    // Frame Pixel Format.
+    m_pixelFormat = enumAttrFn.create("pixelFormat", "pixelFormat", 0, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals pixelFormat attribute");
+
+    enumAttrFn.addField("Float", 0);
+    enumAttrFn.addField("Half", 1);
+
+    status = addAttribute(m_pixelFormat);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals pixelFormat attribute");
+
+    // View transform applied to the pixels sent to the render view.
+    m_renderViewTransform = enumAttrFn.create("renderViewTransform", "renderViewTransform", 0, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals renderViewTransform attribute");
+
+    enumAttrFn.addField("Linear", 0);
+    enumAttrFn.addField("sRGB", 1);
+    enumAttrFn.addField("Rec.709", 2);
+    enumAttrFn.addField("Filmic", 3);
+
+    status = addAttribute(m_renderViewTransform);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals renderViewTransform attribute");
+
+    // Exposure of the render view pixels, in stops.
+    m_renderViewExposure = numAttrFn.create("renderViewExposure", "renderViewExposure", MFnNumericData::kFloat, 0.0f, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals renderViewExposure attribute");
+
+    numAttrFn.setSoftMin(-10.0f);
+    numAttrFn.setSoftMax(10.0f);
+    status = addAttribute(m_renderViewExposure);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals renderViewExposure attribute");
+
+    // Priority region, rendered first in the render view.
+    // Normalized coordinates, Y up like Maya's render region.
+    m_priorityRegion = numAttrFn.create("priorityRegion", "priorityRegion", MFnNumericData::kBoolean, false, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals priorityRegion attribute");
+
+    status = addAttribute(m_priorityRegion);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals priorityRegion attribute");
+
+    m_priorityRegionLeft = numAttrFn.create("priorityRegionLeft", "priorityRegionLeft", MFnNumericData::kFloat, 0.3f, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals priorityRegionLeft attribute");
+
+    numAttrFn.setMin(0.0f);
+    numAttrFn.setMax(1.0f);
+    status = addAttribute(m_priorityRegionLeft);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals priorityRegionLeft attribute");
+
+    m_priorityRegionRight = numAttrFn.create("priorityRegionRight", "priorityRegionRight", MFnNumericData::kFloat, 0.7f, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals priorityRegionRight attribute");
+
+    numAttrFn.setMin(0.0f);
+    numAttrFn.setMax(1.0f);
+    status = addAttribute(m_priorityRegionRight);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals priorityRegionRight attribute");
+
+    m_priorityRegionBottom = numAttrFn.create("priorityRegionBottom", "priorityRegionBottom", MFnNumericData::kFloat, 0.3f, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals priorityRegionBottom attribute");
+
+    numAttrFn.setMin(0.0f);
+    numAttrFn.setMax(1.0f);
+    status = addAttribute(m_priorityRegionBottom);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals priorityRegionBottom attribute");
+
+    m_priorityRegionTop = numAttrFn.create("priorityRegionTop", "priorityRegionTop", MFnNumericData::kFloat, 0.7f, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals priorityRegionTop attribute");
+
+    numAttrFn.setMin(0.0f);
+    numAttrFn.setMax(1.0f);
+    status = addAttribute(m_priorityRegionTop);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals priorityRegionTop attribute");
+
     // GI.
     m_gi = numAttrFn.create("gi", "gi", MFnNumericData::kBoolean, true, &status);
     APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
@@ -244,6 +461,129 @@ MStatus RenderGlobalsNode::initialize()
         status,
         "appleseedMaya: Failed to add render globals threads attribute");
 
+    // Render in a separate process.
+    m_outOfProcess = numAttrFn.create("outOfProcess", "outOfProcess", MFnNumericData::kBoolean, false, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals outOfProcess attribute");
+
+    status = addAttribute(m_outOfProcess);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals outOfProcess attribute");
+
+    // Render process priority.
+    m_processPriority = enumAttrFn.create("processPriority", "processPriority", 1, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals processPriority attribute");
+
+    enumAttrFn.addField("Normal", 0);
+    enumAttrFn.addField("Below Normal", 1);
+    enumAttrFn.addField("Low", 2);
+
+    status = addAttribute(m_processPriority);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals processPriority attribute");
+
+    // Batch render mode.
+    m_batchMode = enumAttrFn.create("batchMode", "batchMode", 0, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals batchMode attribute");
+
+    enumAttrFn.addField("Sequential", 0);
+    enumAttrFn.addField("Pipelined", 1);
+    enumAttrFn.addField("Incremental", 2);
+    enumAttrFn.addField("Local Processes", 3);
+
+    status = addAttribute(m_batchMode);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals batchMode attribute");
+
+    // Batch render processes (0 = auto).
+    m_batchProcesses = numAttrFn.create("batchProcesses", "batchProcesses", MFnNumericData::kInt, 0, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals batchProcesses attribute");
+
+    numAttrFn.setMin(0);
+    status = addAttribute(m_batchProcesses);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals batchProcesses attribute");
+
+    // Rendering threads per batch render process (0 = auto).
+    m_batchProcessThreads = numAttrFn.create("batchProcessThreads", "batchProcessThreads", MFnNumericData::kInt, 0, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals batchProcessThreads attribute");
+
+    numAttrFn.setMin(0);
+    status = addAttribute(m_batchProcessThreads);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals batchProcessThreads attribute");
+
+    // Split the frame between several local render processes.
+    m_distributeFrame = numAttrFn.create("distributeFrame", "distributeFrame", MFnNumericData::kBoolean, false, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals distributeFrame attribute");
+
+    status = addAttribute(m_distributeFrame);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals distributeFrame attribute");
+
+    // Number of frame render processes (0 = one per NUMA node).
+    m_frameWorkers = numAttrFn.create("frameWorkers", "frameWorkers", MFnNumericData::kInt, 0, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals frameWorkers attribute");
+
+    numAttrFn.setMin(0);
+    status = addAttribute(m_frameWorkers);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals frameWorkers attribute");
+
+    // Periodically save the frame of batch renders to a checkpoint file.
+    m_checkpoint = numAttrFn.create("checkpoint", "checkpoint", MFnNumericData::kBoolean, false, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals checkpoint attribute");
+
+    status = addAttribute(m_checkpoint);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals checkpoint attribute");
+
+    // Minimum time between checkpoints, in seconds.
+    m_checkpointInterval = numAttrFn.create("checkpointInterval", "checkpointInterval", MFnNumericData::kInt, 600, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals checkpointInterval attribute");
+
+    numAttrFn.setMin(1);
+    status = addAttribute(m_checkpointInterval);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals checkpointInterval attribute");
+
+    // Resume batch renders from their checkpoint files.
+    m_resumeCheckpoint = numAttrFn.create("resumeCheckpoint", "resumeCheckpoint", MFnNumericData::kBoolean, false, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals resumeCheckpoint attribute");
+
+    status = addAttribute(m_resumeCheckpoint);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals resumeCheckpoint attribute");
+
     // Environment light connection.
     m_envLightNode = msgAttrFn.create("envLight", "env", &status);
     APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
@@ -255,6 +595,93 @@ MStatus RenderGlobalsNode::initialize()
         status,
         "appleseedMaya: Failed to add render globals envLight attribute");
 
+    // AOVs.
+    m_diffuseAOV = numAttrFn.create("diffuseAOV", "diffuseAOV", MFnNumericData::kBoolean, false, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals diffuseAOV attribute");
+
+    status = addAttribute(m_diffuseAOV);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals diffuseAOV attribute");
+
+    m_glossyAOV = numAttrFn.create("glossyAOV", "glossyAOV", MFnNumericData::kBoolean, false, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals glossyAOV attribute");
+
+    status = addAttribute(m_glossyAOV);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals glossyAOV attribute");
+
+    m_emissionAOV = numAttrFn.create("emissionAOV", "emissionAOV", MFnNumericData::kBoolean, false, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals emissionAOV attribute");
+
+    status = addAttribute(m_emissionAOV);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals emissionAOV attribute");
+
+    m_depthAOV = numAttrFn.create("depthAOV", "depthAOV", MFnNumericData::kBoolean, false, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals depthAOV attribute");
+
+    status = addAttribute(m_depthAOV);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals depthAOV attribute");
+
+    m_normalAOV = numAttrFn.create("normalAOV", "normalAOV", MFnNumericData::kBoolean, false, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals normalAOV attribute");
+
+    status = addAttribute(m_normalAOV);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals normalAOV attribute");
+
+    m_albedoAOV = numAttrFn.create("albedoAOV", "albedoAOV", MFnNumericData::kBoolean, false, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals albedoAOV attribute");
+
+    status = addAttribute(m_albedoAOV);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals albedoAOV attribute");
+
+    // OpenEXR output.
+    m_exrCompression = enumAttrFn.create("exrCompression", "exrCompression", 1, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals exrCompression attribute");
+
+    enumAttrFn.addField("None", 0);
+    enumAttrFn.addField("Zip", 1);
+    enumAttrFn.addField("Piz", 2);
+    enumAttrFn.addField("DWAA", 3);
+
+    status = addAttribute(m_exrCompression);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals exrCompression attribute");
+
+    m_exrTiled = numAttrFn.create("exrTiled", "exrTiled", MFnNumericData::kBoolean, true, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to create render globals exrTiled attribute");
+
+    status = addAttribute(m_exrTiled);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedMaya: Failed to add render globals exrTiled attribute");
+
     // Image Format
     m_imageFormat = numAttrFn.create("imageFormat", "imageFormat", MFnNumericData::kInt, 0, &status);
     APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
@@ -281,6 +708,9 @@ void RenderGlobalsNode::applyGlobalsToProject(
     asr::ParamArray& finalParams = project.configurations().get_by_name("final")->get_parameters();
     asr::ParamArray& iprParams   = project.configurations().get_by_name("interactive")->get_parameters();
 
+    int renderMode = 0;
+    AttributeUtils::get(MPlug(globals, m_renderMode), renderMode);
+
     int samples;
     if (AttributeUtils::get(MPlug(globals, m_pixelSamples), samples))
     {
@@ -290,13 +720,47 @@ void RenderGlobalsNode::applyGlobalsToProject(
             finalParams.insert_path("uniform_pixel_renderer.force_antialiasing", true);
     }
 
+    if (renderMode == 2)
+    {
+        // Noise threshold: sample pixels adaptively, up to the pixel samples.
+        int minSamples = 4;
+        AttributeUtils::get(MPlug(globals, m_minPixelSamples), minSamples);
+
+        float noiseThreshold = 0.01f;
+        AttributeUtils::get(MPlug(globals, m_noiseThreshold), noiseThreshold);
+
+        // The adaptive pixel renderer quality is the number of
+        // significant digits of the pixel values: -log10(noise).
+        finalParams.insert("pixel_renderer", "adaptive");
+        finalParams.insert_path("adaptive_pixel_renderer.min_samples", std::min(minSamples, samples));
+        finalParams.insert_path("adaptive_pixel_renderer.max_samples", samples);
+        finalParams.insert_path(
+            "adaptive_pixel_renderer.quality",
+            -std::log10(asf::clamp(noiseThreshold, 0.0001f, 1.0f)));
+    }
+    else
+        finalParams.insert("pixel_renderer", "uniform");
+
     int passes;
     if (AttributeUtils::get(MPlug(globals, m_passes), passes))
     {
+        // Time limit: render passes until the renderer controller terminates rendering.
+        if (renderMode == 1)
+            passes = MaxTimeLimitPasses;
+
         finalParams.insert_path("generic_frame_renderer.passes", passes);
         finalParams.insert_path("shading_result_framebuffer", passes == 1 ? "ephemeral" : "permanent");
     }
 
+    int tileOrdering;
+    if (AttributeUtils::get(MPlug(globals, m_tileOrdering), tileOrdering))
+    {
+        const char* tileOrderings[] = { "linear", "spiral", "hilbert", "random" };
+        finalParams.insert_path(
+            "generic_frame_renderer.tile_ordering",
+            tileOrderings[asf::clamp(tileOrdering, 0, 3)]);
+    }
+
     int diagnostic;
     if (AttributeUtils::get(MPlug(globals, m_diagnosticShader), diagnostic))
     {
@@ -57,7 +57,20 @@ class RenderGlobalsNode
   private:
     static MObject m_pixelSamples;
     static MObject m_passes;
+    static MObject m_renderMode;
+    static MObject m_timeLimit;
+    static MObject m_noiseThreshold;
+    static MObject m_minPixelSamples;
     static MObject m_tileSize;
+    static MObject m_tileOrdering;
+    static MObject m_pixelFormat;
+    static MObject m_renderViewTransform;
+    static MObject m_renderViewExposure;
+    static MObject m_priorityRegion;
+    static MObject m_priorityRegionLeft;
+    static MObject m_priorityRegionRight;
+    static MObject m_priorityRegionBottom;
+    static MObject m_priorityRegionTop;
 
     static MObject      m_diagnosticShader;
     static MStringArray m_diagnosticShaderKeys;
@@ -73,6 +86,26 @@ class RenderGlobalsNode
     static MObject m_backgroundEmitsLight;
 
     static MObject m_renderingThreads;
+    static MObject m_outOfProcess;
+    static MObject m_processPriority;
+    static MObject m_batchMode;
+    static MObject m_batchProcesses;
+    static MObject m_batchProcessThreads;
+    static MObject m_distributeFrame;
+    static MObject m_frameWorkers;
+    static MObject m_checkpoint;
+    static MObject m_checkpointInterval;
+    static MObject m_resumeCheckpoint;
+
+    static MObject m_diffuseAOV;
+    static MObject m_glossyAOV;
+    static MObject m_emissionAOV;
+    static MObject m_depthAOV;
+    static MObject m_normalAOV;
+    static MObject m_albedoAOV;
+
+    static MObject m_exrCompression;
+    static MObject m_exrTiled;
 
     static MObject m_imageFormat;
 };
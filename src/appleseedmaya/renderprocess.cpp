@@ -0,0 +1,181 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "appleseedmaya/renderprocess.h"
+
+// Standard headers.
+#include <cassert>
+#include <cerrno>
+#include <csignal>
+
+// POSIX headers.
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+// Boost headers.
+#include "boost/thread/thread.hpp"
+
+// appleseed.renderer headers.
+#include "renderer/api/log.h"
+
+extern char** environ;
+
+RenderProcess::RenderProcess()
+  : m_pid(-1)
+  , m_exited(false)
+  , m_exitCode(0)
+  , m_signal(0)
+{
+}
+
+RenderProcess::~RenderProcess()
+{
+    terminate();
+}
+
+bool RenderProcess::start(
+    const std::string&              executable,
+    const std::vector<std::string>& args,
+    const int                       niceness)
+{
+    assert(m_pid == -1);
+
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(executable.c_str()));
+    for (size_t i = 0, e = args.size(); i < e; ++i)
+        argv.push_back(const_cast<char*>(args[i].c_str()));
+    argv.push_back(0);
+
+    pid_t pid;
+    const int result = posix_spawn(&pid, executable.c_str(), 0, 0, &argv[0], environ);
+    if (result != 0)
+    {
+        RENDERER_LOG_ERROR(
+            "appleseedMaya: could not launch render process %s (error %d)",
+            executable.c_str(),
+            result);
+        return false;
+    }
+
+    m_pid = pid;
+    m_exited = false;
+    RENDERER_LOG_DEBUG("appleseedMaya: launched render process, pid = %d", static_cast<int>(m_pid));
+
+    if (niceness != 0 && setpriority(PRIO_PROCESS, m_pid, niceness) != 0)
+        RENDERER_LOG_WARNING("appleseedMaya: could not set the render process priority");
+
+    return true;
+}
+
+bool RenderProcess::isRunning()
+{
+    if (m_pid == -1 || m_exited)
+        return false;
+
+    int status;
+    const pid_t result = waitpid(m_pid, &status, WNOHANG);
+
+    if (result == 0)
+        return true;
+
+    if (result == m_pid)
+        setExitStatus(status);
+    else
+        setExitStatus(-1);
+
+    return false;
+}
+
+void RenderProcess::wait()
+{
+    if (m_pid == -1 || m_exited)
+        return;
+
+    int status;
+    pid_t result;
+
+    do
+    {
+        result = waitpid(m_pid, &status, 0);
+    } while (result == -1 && errno == EINTR);
+
+    setExitStatus(result == m_pid ? status : -1);
+}
+
+void RenderProcess::terminate()
+{
+    if (!isRunning())
+        return;
+
+    kill(m_pid, SIGTERM);
+
+    // Give the process some time to exit cleanly.
+    for (int i = 0; i < 50 && isRunning(); ++i)
+        boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+
+    if (isRunning())
+    {
+        RENDERER_LOG_WARNING("appleseedMaya: killing render process, pid = %d", static_cast<int>(m_pid));
+        kill(m_pid, SIGKILL);
+        wait();
+    }
+}
+
+bool RenderProcess::succeeded() const
+{
+    return m_exited && m_signal == 0 && m_exitCode == 0;
+}
+
+bool RenderProcess::crashed() const
+{
+    return m_exited && m_signal != 0;
+}
+
+void RenderProcess::setExitStatus(const int status)
+{
+    m_exited = true;
+
+    if (status == -1)
+    {
+        // The process could not be waited for.
+        m_exitCode = -1;
+        m_signal = 0;
+    }
+    else if (WIFSIGNALED(status))
+    {
+        m_exitCode = -1;
+        m_signal = WTERMSIG(status);
+    }
+    else
+    {
+        m_exitCode = WEXITSTATUS(status);
+        m_signal = 0;
+    }
+}
@@ -0,0 +1,87 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_MAYA_RENDER_PROCESS_H
+#define APPLESEED_MAYA_RENDER_PROCESS_H
+
+// Standard headers.
+#include <string>
+#include <vector>
+
+// POSIX headers.
+#include <sys/types.h>
+
+// appleseed.maya headers.
+#include "appleseedmaya/utils.h"
+
+//
+// RenderProcess.
+//
+//  A child process running the appleseedMaya renderer executable.
+//
+
+class RenderProcess
+  : public NonCopyable
+{
+  public:
+    RenderProcess();
+
+    // Kills the process if it is still running.
+    ~RenderProcess();
+
+    // Launch the process. Niceness is applied to the process once started.
+    bool start(
+        const std::string&              executable,
+        const std::vector<std::string>& args,
+        const int                       niceness = 0);
+
+    // Returns false once the process exited.
+    bool isRunning();
+
+    // Block until the process exits.
+    void wait();
+
+    // Ask the process to exit and wait for it.
+    void terminate();
+
+    // True if the process exited normally with a zero exit code.
+    bool succeeded() const;
+
+    // True if the process was killed by a signal (crashed or terminated).
+    bool crashed() const;
+
+  private:
+    void setExitStatus(const int status);
+
+    pid_t   m_pid;
+    bool    m_exited;
+    int     m_exitCode;
+    int     m_signal;
+};
+
+#endif  // !APPLESEED_MAYA_RENDER_PROCESS_H
@@ -31,9 +31,12 @@
 
 // Standard headers.
 #include <cassert>
+#include <cstring>
 
 // Boost headers.
+#include <boost/cstdint.hpp>
 #include <boost/shared_array.hpp>
+#include <boost/static_assert.hpp>
 
 // Maya headers.
 #include <maya/MRenderView.h>
@@ -50,6 +53,7 @@
 #include "renderer/api/log.h"
 
 // appleseed.maya headers.
+#include "appleseedmaya/halfconversion.h"
 #include "appleseedmaya/idlejobqueue.h"
 #include "appleseedmaya/utils.h"
 
@@ -61,6 +65,19 @@ namespace
 
 const int MaxHighlightSize = 8;
 
+// Rows of RGBA pixels are converted directly into render view pixels.
+BOOST_STATIC_ASSERT(sizeof(RV_PIXEL) == 4 * sizeof(float));
+
+void copyRow(const float* src, RV_PIXEL* dst, const size_t width)
+{
+    std::memcpy(dst, src, width * sizeof(RV_PIXEL));
+}
+
+void copyRow(const boost::uint16_t* src, RV_PIXEL* dst, const size_t width)
+{
+    halfToFloat(src, reinterpret_cast<float*>(dst), 4 * width);
+}
+
 class RenderViewTileCallback
   : public renderer::ITileCallback
 {
@@ -68,10 +85,12 @@ class RenderViewTileCallback
     RenderViewTileCallback(
         const asf::AABB2i&      displayWindow,
         const asf::AABB2i&      dataWindow,
+        const DisplayTransform& displayTransform,
         RendererController&     rendererController,
         ComputationPtr&         computation)
       : m_displayWindow(displayWindow)
       , m_dataWindow(dataWindow)
+      , m_displayTransform(displayTransform)
       , m_rendererController(rendererController)
       , m_computation(computation)
     {
@@ -118,9 +137,16 @@ class RenderViewTileCallback
     {
         const asf::CanvasProperties& frame_props = frame->image().properties();
 
-        for( size_t ty = 0; ty < frame_props.m_tile_count_y; ++ty )
-            for( size_t tx = 0; tx < frame_props.m_tile_count_x; ++tx )
+        // Only write the tiles of the crop window, the frame may be rendered in several windows.
+        const asf::AABB2u& crop_window = frame->get_crop_window();
+        const size_t tx_end = std::min(crop_window.max.x / frame_props.m_tile_width + 1, frame_props.m_tile_count_x);
+        const size_t ty_end = std::min(crop_window.max.y / frame_props.m_tile_height + 1, frame_props.m_tile_count_y);
+
+        for( size_t ty = crop_window.min.y / frame_props.m_tile_height; ty < ty_end; ++ty )
+            for( size_t tx = crop_window.min.x / frame_props.m_tile_width; tx < tx_end; ++tx )
                 write_tile(frame, tx, ty);
+
+        m_rendererController.on_pass_rendered(frame_props.m_pixel_count);
     }
 
     virtual void post_render_tile(
@@ -129,6 +155,9 @@ class RenderViewTileCallback
         const size_t        tile_y)
     {
         write_tile(frame, tile_x, tile_y);
+
+        const asf::Tile& tile = frame->image().tile(tile_x, tile_y);
+        m_rendererController.on_tile_rendered(tile.get_pixel_count());
     }
 
   private:
@@ -248,17 +277,48 @@ class RenderViewTileCallback
         const size_t        tile_y)
     {
         const foundation::Tile& tile = frame->image().tile(tile_x, tile_y);
-        assert(tile.get_pixel_format() == foundation::PixelFormatFloat);
         assert(tile.get_channel_count() == 4);
 
         const asf::CanvasProperties& props = frame->image().properties();
-        const int x0 = tile_x * props.m_tile_width;
-        const int y0 = tile_y * props.m_tile_height;
+
+        if (tile.get_pixel_format() == foundation::PixelFormatHalf)
+        {
+            write_pixels(
+                tile_x * props.m_tile_width,
+                tile_y * props.m_tile_height,
+                tile.get_width(),
+                tile.get_height(),
+                reinterpret_cast<const boost::uint16_t*>(tile.get_storage()));
+        }
+        else
+        {
+            assert(tile.get_pixel_format() == foundation::PixelFormatFloat);
+            write_pixels(
+                tile_x * props.m_tile_width,
+                tile_y * props.m_tile_height,
+                tile.get_width(),
+                tile.get_height(),
+                reinterpret_cast<const float*>(tile.get_storage()));
+        }
+    }
+
+  public:
+    // Write a block of float or half RGBA pixels, stored top to bottom.
+    template <typename T>
+    void write_pixels(
+        const size_t        x,
+        const size_t        y,
+        const size_t        width,
+        const size_t        height,
+        const T*            src)
+    {
+        const int x0 = x;
+        const int y0 = y;
 
         int xmin = x0;
         int ymin = y0;
-        int xmax = xmin + tile.get_width() - 1;
-        int ymax = ymin + tile.get_height() - 1;
+        int xmax = xmin + width - 1;
+        int ymax = ymin + height - 1;
 
         if (!intersect_with_data_window(xmin, ymin, xmax, ymax))
             return;
@@ -269,19 +329,13 @@ class RenderViewTileCallback
         RV_PIXEL* p = pixels.get();
 
         // Copy and flip the tile verticaly (Maya's renderview is y up).
-        for (int j = ymax; j >= ymin; --j)
-        {
-            size_t y = j - y0;
+        for (int j = ymax; j >= ymin; --j, p += w)
+            copyRow(src + ((j - y0) * width + (xmin - x0)) * 4, p, w);
 
-            for (int i = xmin; i <= xmax; ++i)
-            {
-                const size_t x = i - x0;
-                p->r = tile.get_component<float>(x, y, 0);
-                p->g = tile.get_component<float>(x, y, 1);
-                p->b = tile.get_component<float>(x, y, 2);
-                p->a = tile.get_component<float>(x, y, 3);
-                p++;
-            }
+        if (!m_displayTransform.isIdentity())
+        {
+            float* rgba = reinterpret_cast<float*>(pixels.get());
+            m_displayTransform.apply(rgba, rgba, w * h);
         }
 
         flip_pixel_interval(displayWindowHeight(), ymin, ymax);
@@ -289,6 +343,7 @@ class RenderViewTileCallback
         IdleJobQueue::pushJob(tileJob);
     }
 
+  private:
     int displayWindowHeight() const
     {
         return m_displayWindow.max.y + 1;
@@ -311,11 +366,12 @@ class RenderViewTileCallback
         return true;
     }
 
-    RV_PIXEL            m_highlightPixels[MaxHighlightSize];
-    const asf::AABB2i   m_displayWindow;
-    const asf::AABB2i   m_dataWindow;
-    RendererController& m_rendererController;
-    ComputationPtr      m_computation;
+    RV_PIXEL                m_highlightPixels[MaxHighlightSize];
+    const asf::AABB2i       m_displayWindow;
+    const asf::AABB2i       m_dataWindow;
+    const DisplayTransform& m_displayTransform;
+    RendererController&     m_rendererController;
+    ComputationPtr          m_computation;
 };
 
 } // unnamed.
@@ -325,11 +381,15 @@ RenderViewTileCallbackFactory::RenderViewTileCallbackFactory(
     ComputationPtr       computation)
   : m_rendererController(rendererController)
   , m_computation(computation)
+  , m_tileCallback(0)
 {
 }
 
 RenderViewTileCallbackFactory::~RenderViewTileCallbackFactory()
 {
+    if (m_tileCallback)
+        m_tileCallback->release();
+
     MRenderView::endRender();
 }
 
@@ -343,6 +403,7 @@ renderer::ITileCallback* RenderViewTileCallbackFactory::create()
     return new RenderViewTileCallback(
         m_displayWindow,
         m_dataWindow,
+        m_displayTransform,
         m_rendererController,
         m_computation);
 }
@@ -379,3 +440,36 @@ void RenderViewTileCallbackFactory::renderViewStart(const renderer::Frame& frame
         MRenderView::startRender(width, height, false, true);
     }
 }
+
+void RenderViewTileCallbackFactory::setDisplayTransform(const DisplayTransform& displayTransform)
+{
+    m_displayTransform = displayTransform;
+}
+
+void RenderViewTileCallbackFactory::highlightTile(
+    const size_t        x,
+    const size_t        y,
+    const size_t        width,
+    const size_t        height)
+{
+    tileCallback()->pre_render(x, y, width, height);
+}
+
+void RenderViewTileCallbackFactory::writeTile(
+    const size_t        x,
+    const size_t        y,
+    const size_t        width,
+    const size_t        height,
+    const float*        pixels)
+{
+    static_cast<RenderViewTileCallback*>(tileCallback())->write_pixels(x, y, width, height, pixels);
+}
+
+renderer::ITileCallback* RenderViewTileCallbackFactory::tileCallback()
+{
+    // Created on first use, after renderViewStart set the display and data windows.
+    if (m_tileCallback == 0)
+        m_tileCallback = create();
+
+    return m_tileCallback;
+}
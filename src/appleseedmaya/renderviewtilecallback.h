@@ -42,6 +42,7 @@
 #include "renderer/api/rendering.h"
 
 // appleseed.maya headers.
+#include "appleseedmaya/displaytransform.h"
 #include "appleseedmaya/renderercontroller.h"
 #include "appleseedmaya/utils.h"
 
@@ -67,11 +68,34 @@ class RenderViewTileCallbackFactory
 
     void renderViewStart(const renderer::Frame& frame);
 
+    // Transform the pixels sent to the render view. Must be called before rendering.
+    void setDisplayTransform(const DisplayTransform& displayTransform);
+
+    // Display tiles rendered outside of a master renderer using this factory
+    // (for example, received from a render process). Not thread safe.
+    void highlightTile(
+        const size_t        x,
+        const size_t        y,
+        const size_t        width,
+        const size_t        height);
+
+    // Pixels are float RGBA, stored top to bottom.
+    void writeTile(
+        const size_t        x,
+        const size_t        y,
+        const size_t        width,
+        const size_t        height,
+        const float*        pixels);
+
   private:
-    RendererController& m_rendererController;
-    ComputationPtr      m_computation;
-    foundation::AABB2i  m_displayWindow;
-    foundation::AABB2i  m_dataWindow;
+    renderer::ITileCallback* tileCallback();
+
+    RendererController&         m_rendererController;
+    ComputationPtr              m_computation;
+    foundation::AABB2i          m_displayWindow;
+    foundation::AABB2i          m_dataWindow;
+    DisplayTransform            m_displayTransform;
+    renderer::ITileCallback*    m_tileCallback;
 };
 
 #endif  // !APPLESEED_MAYA_RENDERVIEW_TILECALLBACK_H
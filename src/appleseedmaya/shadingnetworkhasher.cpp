@@ -0,0 +1,185 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "appleseedmaya/shadingnetworkhasher.h"
+
+// Standard headers.
+#include <ctime>
+
+// Boost headers.
+#include "boost/filesystem/operations.hpp"
+#include "boost/system/error_code.hpp"
+
+// Maya headers.
+#include <maya/MFn.h>
+#include <maya/MFnData.h>
+#include <maya/MFnDependencyNode.h>
+#include <maya/MFnNumericAttribute.h>
+#include <maya/MFnNumericData.h>
+#include <maya/MFnTypedAttribute.h>
+#include <maya/MObject.h>
+#include <maya/MPlug.h>
+#include <maya/MStatus.h>
+
+// appleseed.maya headers.
+#include "appleseedmaya/attributeutils.h"
+#include "appleseedmaya/murmurhash.h"
+#include "appleseedmaya/shadingnodemetadata.h"
+#include "appleseedmaya/shadingnoderegistry.h"
+
+ShadingNetworkHasher::ShadingNetworkHasher(MurmurHash& hash)
+  : m_hash(hash)
+{
+}
+
+void ShadingNetworkHasher::hashNode(const MObject& node)
+{
+    MFnDependencyNode depNodeFn(node);
+
+    // Nodes reachable by more than one path are hashed only once.
+    // Their visit order is enough to identify them.
+    NodeIndexMap::const_iterator it = m_visitedNodes.find(depNodeFn.name());
+    if (it != m_visitedNodes.end())
+    {
+        m_hash.append(it->second);
+        return;
+    }
+
+    const size_t index = m_visitedNodes.size();
+    m_visitedNodes[depNodeFn.name()] = index;
+    m_hash.append(index);
+    m_hash.append(depNodeFn.typeName());
+
+    const OSLShaderInfo *shaderInfo = ShadingNodeRegistry::getShaderInfo(depNodeFn.typeName());
+    if (shaderInfo == 0)
+        return;
+
+    for(size_t i = 0, e = shaderInfo->paramInfo.size(); i < e; ++i)
+    {
+        const OSLParamInfo& paramInfo = shaderInfo->paramInfo[i];
+
+        if (paramInfo.isOutput)
+            continue;
+
+        MStatus status;
+        MPlug plug = depNodeFn.findPlug(paramInfo.mayaAttributeName, &status);
+        if (!status)
+            continue;
+
+        m_hash.append(paramInfo.paramName);
+        hashPlug(plug);
+    }
+}
+
+void ShadingNetworkHasher::hashPlug(const MPlug& plug)
+{
+    MStatus status;
+
+    if (plug.isConnected())
+    {
+        MPlug srcPlug;
+        if (AttributeUtils::getPlugConnectedTo(plug, srcPlug))
+        {
+            m_hash.append(
+                srcPlug.partialName(
+                    false,
+                    false,
+                    false,
+                    false,
+                    false,
+                    true,   // use long names.
+                    &status));
+            hashNode(srcPlug.node());
+            return;
+        }
+    }
+
+    if (plug.isCompound())
+    {
+        for(unsigned int i = 0, e = plug.numChildren(); i < e; ++i)
+        {
+            MPlug childPlug = plug.child(i, &status);
+            if (status)
+                hashPlug(childPlug);
+        }
+    }
+    else if (plug.isArray())
+    {
+        const unsigned int numElements = plug.numElements();
+        m_hash.append(numElements);
+
+        for(unsigned int i = 0; i < numElements; ++i)
+        {
+            MPlug elementPlug = plug.elementByPhysicalIndex(i, &status);
+            if (status)
+            {
+                m_hash.append(elementPlug.logicalIndex());
+                hashPlug(elementPlug);
+            }
+        }
+    }
+    else
+        hashPlugValue(plug);
+}
+
+void ShadingNetworkHasher::hashPlugValue(const MPlug& plug)
+{
+    const MObject attr = plug.attribute();
+
+    if (attr.hasFn(MFn::kTypedAttribute))
+    {
+        MFnTypedAttribute typedAttrFn(attr);
+        if (typedAttrFn.attrType() == MFnData::kString)
+        {
+            const MString value = plug.asString();
+            m_hash.append(value);
+
+            // Texture files can change on disk, hash their modification time too.
+            if (value.length() != 0)
+            {
+                boost::system::error_code ec;
+                const std::time_t mtime = boost::filesystem::last_write_time(value.asChar(), ec);
+                if (!ec)
+                    m_hash.append(mtime);
+            }
+        }
+    }
+    else if (attr.hasFn(MFn::kNumericAttribute))
+    {
+        MFnNumericAttribute numAttrFn(attr);
+        if (numAttrFn.unitType() == MFnNumericData::kBoolean)
+            m_hash.append(plug.asBool());
+        else
+            m_hash.append(plug.asDouble());
+    }
+    else if (attr.hasFn(MFn::kEnumAttribute))
+        m_hash.append(plug.asInt());
+    else if (attr.hasFn(MFn::kUnitAttribute))
+        m_hash.append(plug.asDouble());
+}
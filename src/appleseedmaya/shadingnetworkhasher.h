@@ -0,0 +1,73 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_MAYA_SHADING_NETWORK_HASHER_H
+#define APPLESEED_MAYA_SHADING_NETWORK_HASHER_H
+
+// Standard headers.
+#include <cstddef>
+#include <map>
+
+// Maya headers.
+#include <maya/MString.h>
+
+// appleseed.maya headers.
+#include "appleseedmaya/utils.h"
+
+// Forward declarations.
+class MObject;
+class MPlug;
+class MurmurHash;
+
+//
+// ShadingNetworkHasher.
+//
+//  Hashes the topology and the parameter values of the OSL shading network
+//  upstream of a node, and the modification time of the files named by string
+//  parameters. Two networks with the same hash render the same.
+//
+
+class ShadingNetworkHasher
+  : NonCopyable
+{
+  public:
+    explicit ShadingNetworkHasher(MurmurHash& hash);
+
+    void hashNode(const MObject& node);
+
+  private:
+    typedef std::map<MString, size_t, MStringCompareLess> NodeIndexMap;
+
+    void hashPlug(const MPlug& plug);
+    void hashPlugValue(const MPlug& plug);
+
+    MurmurHash&     m_hash;
+    NodeIndexMap    m_visitedNodes;
+};
+
+#endif  // !APPLESEED_MAYA_SHADING_NETWORK_HASHER_H
@@ -37,6 +37,12 @@
 
 // Boost headers.
 #include "boost/filesystem.hpp"
+#include "boost/shared_ptr.hpp"
+
+// tbb headers.
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
 
 // Maya headers.
 #define MNoPluginEntry
@@ -114,133 +120,198 @@ void logShader(const OSLShaderInfo& s)
 typedef std::map<MString, OSLShaderInfo, MStringCompareLess> OSLShaderInfoMap;
 OSLShaderInfoMap gShadersInfo;
 
-bool doRegisterShader(
-    const bfs::path&    shaderPath,
-    MFnPlugin&          pluginFn,
-    asr::ShaderQuery&   query)
+//
+// Shader registration is done in two phases.
+//
+//  The first phase queries all the .oso files found in the search paths
+//  in parallel, using one ShaderQuery per worker thread.
+//  The second phase runs in the main thread and registers the queried shaders
+//  with Maya in the same order the files were found, so that shaders
+//  in later search paths still override earlier ones.
+//
+
+struct ShaderQueryResult
 {
-    if (query.open(shaderPath.string().c_str()))
+    ShaderQueryResult()
+      : m_valid(false)
     {
-        OSLShaderInfo shaderInfo(query);
-
-        if (shaderInfo.mayaName.length() == 0)
-        {
-            RENDERER_LOG_DEBUG(
-                "Skipping registration for OSL shader %s. No maya name metadata found.",
-                shaderInfo.shaderName.asChar());
-            return false;
-        }
-
-        if (gShadersInfo.count(shaderInfo.mayaName) != 0)
-        {
-            RENDERER_LOG_DEBUG(
-                "Skipping registration for OSL shader %s. Already registered.",
-                shaderInfo.shaderName.asChar());
-            return false;
-        }
-
-        if (shaderInfo.typeId != 0)
-        {
-            if (shaderInfo.mayaClassification.length() == 0)
-            {
-                RENDERER_LOG_DEBUG(
-                    "Skipping registration for OSL shader %s. No maya classification metadata found.",
-                    shaderInfo.shaderName.asChar());
-                return false;
-            }
-        }
-
-        RENDERER_LOG_DEBUG(
-            "Registered OSL shader %s",
-            shaderInfo.shaderName.asChar());
-
-        gShadersInfo[shaderInfo.mayaName] = shaderInfo;
-
-        /*
-        #ifndef NDEBUG
-            logShader(shaderInfo);
-        #endif
-        */
-
-        if (shaderInfo.typeId != 0)
-        {
-            // This shader is not a builtin node or a node from other plugin.
-            // Create a MPxNode for this shader.
-            RENDERER_LOG_INFO(
-                "Registering MPxNode for OSL shader %s.",
-                shaderInfo.shaderName.asChar());
-
-            ShadingNode::setCurrentShaderInfo(&shaderInfo);
-            MStatus status = pluginFn.registerNode(
-                shaderInfo.mayaName,
-                MTypeId(shaderInfo.typeId),
-                &ShadingNode::creator,
-                &ShadingNode::initialize,
-                MPxNode::kDependNode,
-                &shaderInfo.mayaClassification);
+    }
 
-            if (!status)
-            {
-                RENDERER_LOG_WARNING(
-                    "Registration of OSL shader %s failed, error = %s.",
-                    shaderInfo.shaderName.asChar(),
-                    status.errorString().asChar());
+    bfs::path       m_shaderPath;
+    bool            m_valid;
+    OSLShaderInfo   m_shaderInfo;
+};
 
-                gShadersInfo.erase(shaderInfo.mayaName);
-                return false;
-            }
+typedef boost::shared_ptr<asr::ShaderQuery>                     ShaderQueryPtr;
+typedef tbb::enumerable_thread_specific<ShaderQueryPtr>         ThreadLocalShaderQuery;
 
-            // Build and register an AE template for the node.
-            ShadingNodeTemplateBuilder aeBuilder(shaderInfo);
-            #ifndef NDEBUG
-                aeBuilder.logAETemplate();
-            #endif
-            aeBuilder.registerAETemplate();
-        }
+void releaseShaderQuery(asr::ShaderQuery* query)
+{
+    query->release();
+}
 
+bool doQueryShader(
+    asr::ShaderQuery&   query,
+    ShaderQueryResult&  result)
+{
+    if (query.open(result.m_shaderPath.string().c_str()))
+    {
+        result.m_shaderInfo = OSLShaderInfo(query);
         return true;
     }
 
     return false;
 }
 
-bool registerShader(
-    const bfs::path&    shaderPath,
-    MFnPlugin&          pluginFn,
-    asr::ShaderQuery&   query)
+bool queryShader(
+    asr::ShaderQuery&   query,
+    ShaderQueryResult&  result)
 {
     try
     {
-        return doRegisterShader(shaderPath, pluginFn, query);
+        return doQueryShader(query, result);
     }
     catch (const asf::StringException& e)
     {
         RENDERER_LOG_ERROR(
             "OSL shader query for shader %s failed, error = %s.",
-            shaderPath.string().c_str(),
+            result.m_shaderPath.string().c_str(),
             e.string());
     }
     catch (const std::exception& e)
     {
         RENDERER_LOG_ERROR(
             "OSL shader query for shader %s failed, error = %s.",
-            shaderPath.string().c_str(),
+            result.m_shaderPath.string().c_str(),
             e.what());
     }
     catch (...)
     {
         RENDERER_LOG_ERROR(
             "OSL shader query for shader %s failed.",
-            shaderPath.string().c_str());
+            result.m_shaderPath.string().c_str());
     }
 
     return false;
 }
 
-void registerShadersInDirectory(
-    const bfs::path&    shaderDir,
-    MFnPlugin&          pluginFn,
-    asr::ShaderQuery&   query)
+class QueryShadersBody
+{
+  public:
+    QueryShadersBody(
+        std::vector<ShaderQueryResult>& results,
+        ThreadLocalShaderQuery&         queries)
+      : m_results(results)
+      , m_queries(queries)
+    {
+    }
+
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+        ShaderQueryPtr& query = m_queries.local();
+
+        if (!query)
+            query.reset(asr::ShaderQueryFactory::create().release(), &releaseShaderQuery);
+
+        for (size_t i = r.begin(), e = r.end(); i < e; ++i)
+            m_results[i].m_valid = queryShader(*query, m_results[i]);
+    }
+
+  private:
+    std::vector<ShaderQueryResult>& m_results;
+    ThreadLocalShaderQuery&         m_queries;
+};
+
+void queryShaders(std::vector<ShaderQueryResult>& results)
+{
+    ThreadLocalShaderQuery queries;
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, results.size()),
+        QueryShadersBody(results, queries));
+}
+
+bool registerShader(
+    const OSLShaderInfo&    shaderInfo,
+    MFnPlugin&              pluginFn,
+    MString&                aeTemplateStubs)
+{
+    if (shaderInfo.mayaName.length() == 0)
+    {
+        RENDERER_LOG_DEBUG(
+            "Skipping registration for OSL shader %s. No maya name metadata found.",
+            shaderInfo.shaderName.asChar());
+        return false;
+    }
+
+    if (gShadersInfo.count(shaderInfo.mayaName) != 0)
+    {
+        RENDERER_LOG_DEBUG(
+            "Skipping registration for OSL shader %s. Already registered.",
+            shaderInfo.shaderName.asChar());
+        return false;
+    }
+
+    if (shaderInfo.typeId != 0)
+    {
+        if (shaderInfo.mayaClassification.length() == 0)
+        {
+            RENDERER_LOG_DEBUG(
+                "Skipping registration for OSL shader %s. No maya classification metadata found.",
+                shaderInfo.shaderName.asChar());
+            return false;
+        }
+    }
+
+    RENDERER_LOG_DEBUG(
+        "Registered OSL shader %s",
+        shaderInfo.shaderName.asChar());
+
+    gShadersInfo[shaderInfo.mayaName] = shaderInfo;
+
+    /*
+    #ifndef NDEBUG
+        logShader(shaderInfo);
+    #endif
+    */
+
+    if (shaderInfo.typeId != 0)
+    {
+        // This shader is not a builtin node or a node from other plugin.
+        // Create a MPxNode for this shader.
+        RENDERER_LOG_DEBUG(
+            "Registering MPxNode for OSL shader %s.",
+            shaderInfo.shaderName.asChar());
+
+        ShadingNode::setCurrentShaderInfo(&shaderInfo);
+        MStatus status = pluginFn.registerNode(
+            shaderInfo.mayaName,
+            MTypeId(shaderInfo.typeId),
+            &ShadingNode::creator,
+            &ShadingNode::initialize,
+            MPxNode::kDependNode,
+            &shaderInfo.mayaClassification);
+
+        if (!status)
+        {
+            RENDERER_LOG_WARNING(
+                "Registration of OSL shader %s failed, error = %s.",
+                shaderInfo.shaderName.asChar(),
+                status.errorString().asChar());
+
+            gShadersInfo.erase(shaderInfo.mayaName);
+            return false;
+        }
+
+        // The full AE template is built the first time it is needed.
+        aeTemplateStubs += ShadingNodeTemplateBuilder::aeTemplateStub(shaderInfo.mayaName);
+    }
+
+    return true;
+}
+
+void findShadersInDirectory(
+    const bfs::path&                shaderDir,
+    std::vector<ShaderQueryResult>& results)
 {
     try
     {
@@ -259,7 +330,8 @@ void registerShadersInDirectory(
                             "Found OSL shader %s.",
                             shaderPath.string().c_str());
 
-                        registerShader(shaderPath, pluginFn, query);
+                        results.push_back(ShaderQueryResult());
+                        results.back().m_shaderPath = shaderPath;
                     }
                 }
 
@@ -308,19 +380,40 @@ MStatus registerShadingNodes(MObject plugin)
             shaderPaths.push_back(bfs::path(paths[i]));
     }
 
-    asf::auto_release_ptr<asr::ShaderQuery> query =
-        asr::ShaderQueryFactory::create();
-
     // Iterate in reverse order to allow overriding of shaders.
+    std::vector<ShaderQueryResult> shaders;
     for(int i = shaderPaths.size() - 1; i >= 0; --i)
     {
         RENDERER_LOG_INFO(
             "Looking for OSL shaders in path %s.",
             shaderPaths[i].string().c_str());
 
-        registerShadersInDirectory(shaderPaths[i], pluginFn, *query);
+        findShadersInDirectory(shaderPaths[i], shaders);
+    }
+
+    // Query the shaders in parallel.
+    queryShaders(shaders);
+
+    // Register the shaders with Maya, in the order they were found.
+    size_t numRegistered = 0;
+    MString aeTemplateStubs;
+    for(size_t i = 0, e = shaders.size(); i < e; ++i)
+    {
+        if (shaders[i].m_valid)
+        {
+            if (registerShader(shaders[i].m_shaderInfo, pluginFn, aeTemplateStubs))
+                ++numRegistered;
+        }
     }
 
+    RENDERER_LOG_INFO(
+        "Registered %u OSL shaders.",
+        static_cast<unsigned int>(numRegistered));
+
+    // Register all the AE template stubs at once.
+    if (aeTemplateStubs.length() != 0)
+        MGlobal::executeCommand(aeTemplateStubs);
+
     MString command("if (`window -exists createRenderNodeWindow`) {refreshCreateRenderNodeWindow(\"\");}\n");
     MGlobal::executeCommand(command);
 
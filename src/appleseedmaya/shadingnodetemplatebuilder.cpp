@@ -35,10 +35,14 @@
 #include <sstream>
 
 // Maya headers.
+#include <maya/MArgDatabase.h>
 #include <maya/MGlobal.h>
 #include <maya/MStatus.h>
+#include <maya/MSyntax.h>
 
 // appleseed.maya headers.
+#include "appleseedmaya/config.h"
+#include "appleseedmaya/logger.h"
 #include "appleseedmaya/shadingnodemetadata.h"
 #include "appleseedmaya/shadingnoderegistry.h"
 
@@ -51,7 +55,7 @@ ShadingNodeTemplateBuilder::ShadingNodeTemplateBuilder(const OSLShaderInfo& shad
     // Import the bump control.
     ss << "source AElambertCommon;\n";
 
-    ss << "global proc AE" << shaderInfo.mayaName << "Template(string $nodeName)\n";
+    ss << "global proc " << layoutProcName(shaderInfo.mayaName) << "(string $nodeName)\n";
     ss << "{\n";
     ss << "    AEswatchDisplay $nodeName;\n";
     ss << "    editorTemplate -beginScrollLayout;\n";
@@ -112,6 +116,21 @@ ShadingNodeTemplateBuilder::ShadingNodeTemplateBuilder(const OSLShaderInfo& shad
     m_melTemplate = ss.str().c_str();
 }
 
+MString ShadingNodeTemplateBuilder::layoutProcName(const MString& mayaName)
+{
+    return MString("AE") + mayaName + MString("Layout");
+}
+
+MString ShadingNodeTemplateBuilder::aeTemplateStub(const MString& mayaName)
+{
+    std::stringstream ss;
+    ss << "global proc AE" << mayaName << "Template(string $nodeName)\n";
+    ss << "{\n";
+    ss << "    AEappleseedShaderTemplate $nodeName;\n";
+    ss << "}\n";
+    return ss.str().c_str();
+}
+
 MStatus ShadingNodeTemplateBuilder::registerAETemplate() const
 {
     return MGlobal::executeCommand(m_melTemplate);
@@ -127,7 +146,7 @@ void ShadingNodeTemplateBuilder::buildPageList(
     std::vector<MString>&   pages) const
 {
     // Naive and slow, but the number of pages and parameters should be small,
-    // and we do the work only once at startup.
+    // and we do the work only once per node type.
     for(size_t i = 0, e = shaderInfo.paramInfo.size(); i < e; ++i)
     {
         const OSLParamInfo& p = shaderInfo.paramInfo[i];
@@ -138,3 +157,54 @@ void ShadingNodeTemplateBuilder::buildPageList(
         }
     }
 }
+
+MString ShadingNodeTemplateCommand::cmdName("appleseedShadingNodeTemplate");
+
+MSyntax ShadingNodeTemplateCommand::syntaxCreator()
+{
+    MSyntax syntax;
+    syntax.addArg(MSyntax::kString);
+    return syntax;
+}
+
+void* ShadingNodeTemplateCommand::creator()
+{
+    return new ShadingNodeTemplateCommand();
+}
+
+MStatus ShadingNodeTemplateCommand::doIt(const MArgList& args)
+{
+    MStatus status;
+    MArgDatabase argData(syntax(), args, &status);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedShadingNodeTemplate: Invalid arguments.");
+
+    MString nodeType;
+    status = argData.getCommandArgument(0, nodeType);
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedShadingNodeTemplate: Missing node type argument.");
+
+    const OSLShaderInfo *shaderInfo = ShadingNodeRegistry::getShaderInfo(nodeType);
+    APPLESEED_MAYA_ENFORCE_RET_FAILURE_MSG(
+        shaderInfo != 0,
+        "appleseedShadingNodeTemplate: Unknown shading node type.");
+
+    RENDERER_LOG_DEBUG(
+        "Building AE template for shading node %s.",
+        nodeType.asChar());
+
+    ShadingNodeTemplateBuilder aeBuilder(*shaderInfo);
+    #ifndef NDEBUG
+        aeBuilder.logAETemplate();
+    #endif
+
+    status = aeBuilder.registerAETemplate();
+    APPLESEED_MAYA_CHECK_MSTATUS_RET_MSG(
+        status,
+        "appleseedShadingNodeTemplate: Failed to register AE template.");
+
+    setResult(ShadingNodeTemplateBuilder::layoutProcName(nodeType));
+    return MS::kSuccess;
+}
@@ -33,6 +33,7 @@
 #include <vector>
 
 // Maya headers.
+#include <maya/MPxCommand.h>
 #include <maya/MString.h>
 
 // appleseed.maya headers.
@@ -47,6 +48,11 @@ class OSLShaderInfo;
 //
 //  Builds a Mel template for a shading node from shaders metadata.
 //
+//  Templates are built on demand, the first time the attribute editor
+//  is shown for a node type. At plugin load time, only a small stub template
+//  that forwards to the generic AEappleseedShaderTemplate procedure
+//  is registered for each shader.
+//
 
 class ShadingNodeTemplateBuilder
   : NonCopyable
@@ -55,6 +61,12 @@ class ShadingNodeTemplateBuilder
     // Constructor.
     explicit ShadingNodeTemplateBuilder(const OSLShaderInfo& shaderInfo);
 
+    // Return the name of the Mel procedure that builds the AE layout.
+    static MString layoutProcName(const MString& mayaName);
+
+    // Return the stub AE template for a shading node.
+    static MString aeTemplateStub(const MString& mayaName);
+
     // Register a Mel template with Maya.
     MStatus registerAETemplate() const;
 
@@ -69,4 +81,23 @@ class ShadingNodeTemplateBuilder
     MString m_melTemplate;
 };
 
+//
+// ShadingNodeTemplateCommand.
+//
+//  Builds and registers the AE template for an OSL shading node type.
+//  Called from AEappleseedShaderTemplate the first time the template is needed.
+//
+
+class ShadingNodeTemplateCommand
+  : public MPxCommand
+{
+  public:
+    static MString cmdName;
+
+    static MSyntax syntaxCreator();
+    static void* creator();
+
+    virtual MStatus doIt(const MArgList& args);
+};
+
 #endif  // !APPLESEED_MAYA_SHADING_NODE_TEMPLATE_BUILDER_H
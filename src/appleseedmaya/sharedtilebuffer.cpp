@@ -0,0 +1,338 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "appleseedmaya/sharedtilebuffer.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+// POSIX headers.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Boost headers.
+#include "boost/atomic.hpp"
+#include "boost/cstdint.hpp"
+#include "boost/static_assert.hpp"
+#include "boost/thread/thread.hpp"
+
+// appleseed.renderer headers.
+#include "renderer/api/log.h"
+
+// Shared memory is mapped at different addresses in each process,
+// so the atomics must not rely on process local locks.
+BOOST_STATIC_ASSERT(BOOST_ATOMIC_INT32_LOCK_FREE == 2);
+
+namespace
+{
+
+const boost::uint32_t Magic = 0x41534d42;   // 'ASMB'
+const boost::uint32_t Version = 1;
+
+struct SlotHeader
+{
+    boost::uint32_t m_kind;
+    boost::uint32_t m_x;
+    boost::uint32_t m_y;
+    boost::uint32_t m_width;
+    boost::uint32_t m_height;
+    boost::uint32_t m_padding[3];
+};
+
+void sleepMilliseconds(const int ms)
+{
+    boost::this_thread::sleep(boost::posix_time::milliseconds(ms));
+}
+
+} // unnamed.
+
+struct SharedTileBuffer::Header
+{
+    boost::uint32_t                 m_magic;
+    boost::uint32_t                 m_version;
+    boost::uint32_t                 m_frameWidth;
+    boost::uint32_t                 m_frameHeight;
+    boost::uint32_t                 m_slotCount;
+    boost::uint32_t                 m_slotSize;     // In bytes, including the slot header.
+    boost::uint32_t                 m_slotPixels;   // Max pixels per slot.
+
+    // Indices grow monotonically, slot = index % slotCount.
+    boost::atomic<boost::uint32_t>  m_writeIndex;
+    boost::atomic<boost::uint32_t>  m_readIndex;
+    boost::atomic<boost::uint32_t>  m_state;
+    boost::atomic<boost::uint32_t>  m_abort;
+};
+
+SharedTileBuffer* SharedTileBuffer::create(
+    const std::string&  name,
+    const size_t        frameWidth,
+    const size_t        frameHeight,
+    const size_t        tileWidth,
+    const size_t        tileHeight,
+    const size_t        slotCount)
+{
+    assert(slotCount > 0);
+
+    const size_t slotPixels = tileWidth * tileHeight;
+    const size_t slotSize = sizeof(SlotHeader) + slotPixels * 4 * sizeof(float);
+    const size_t size = sizeof(Header) + slotCount * slotSize;
+
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd == -1)
+    {
+        RENDERER_LOG_ERROR("appleseedMaya: could not create shared memory segment %s", name.c_str());
+        return 0;
+    }
+
+    if (ftruncate(fd, size) == -1)
+    {
+        RENDERER_LOG_ERROR("appleseedMaya: could not resize shared memory segment %s", name.c_str());
+        close(fd);
+        shm_unlink(name.c_str());
+        return 0;
+    }
+
+    void* address = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        RENDERER_LOG_ERROR("appleseedMaya: could not map shared memory segment %s", name.c_str());
+        shm_unlink(name.c_str());
+        return 0;
+    }
+
+    Header* header = new (address) Header();
+    header->m_magic = Magic;
+    header->m_version = Version;
+    header->m_frameWidth = static_cast<boost::uint32_t>(frameWidth);
+    header->m_frameHeight = static_cast<boost::uint32_t>(frameHeight);
+    header->m_slotCount = static_cast<boost::uint32_t>(slotCount);
+    header->m_slotSize = static_cast<boost::uint32_t>(slotSize);
+    header->m_slotPixels = static_cast<boost::uint32_t>(slotPixels);
+    header->m_writeIndex.store(0);
+    header->m_readIndex.store(0);
+    header->m_state.store(Rendering);
+    header->m_abort.store(0);
+
+    return new SharedTileBuffer(name, address, size, true);
+}
+
+SharedTileBuffer* SharedTileBuffer::open(const std::string& name)
+{
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd == -1)
+    {
+        RENDERER_LOG_ERROR("appleseedMaya: could not open shared memory segment %s", name.c_str());
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(Header))
+    {
+        RENDERER_LOG_ERROR("appleseedMaya: invalid shared memory segment %s", name.c_str());
+        close(fd);
+        return 0;
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* address = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        RENDERER_LOG_ERROR("appleseedMaya: could not map shared memory segment %s", name.c_str());
+        return 0;
+    }
+
+    const Header* header = static_cast<const Header*>(address);
+    if (header->m_magic != Magic ||
+        header->m_version != Version ||
+        sizeof(Header) + header->m_slotCount * header->m_slotSize > size)
+    {
+        RENDERER_LOG_ERROR("appleseedMaya: invalid shared memory segment %s", name.c_str());
+        munmap(address, size);
+        return 0;
+    }
+
+    return new SharedTileBuffer(name, address, size, false);
+}
+
+SharedTileBuffer::SharedTileBuffer(
+    const std::string&  name,
+    void*               address,
+    const size_t        size,
+    const bool          owner)
+  : m_name(name)
+  , m_address(address)
+  , m_size(size)
+  , m_owner(owner)
+  , m_header(static_cast<Header*>(address))
+{
+}
+
+SharedTileBuffer::~SharedTileBuffer()
+{
+    munmap(m_address, m_size);
+
+    if (m_owner)
+        shm_unlink(m_name.c_str());
+}
+
+const std::string& SharedTileBuffer::name() const
+{
+    return m_name;
+}
+
+size_t SharedTileBuffer::frameWidth() const
+{
+    return m_header->m_frameWidth;
+}
+
+size_t SharedTileBuffer::frameHeight() const
+{
+    return m_header->m_frameHeight;
+}
+
+bool SharedTileBuffer::writeHighlight(
+    const size_t        x,
+    const size_t        y,
+    const size_t        width,
+    const size_t        height)
+{
+    return write(TileHighlight, x, y, width, height, 0);
+}
+
+bool SharedTileBuffer::writeTile(
+    const size_t        x,
+    const size_t        y,
+    const size_t        width,
+    const size_t        height,
+    const float*        pixels)
+{
+    return write(TilePixels, x, y, width, height, pixels);
+}
+
+bool SharedTileBuffer::write(
+    const TileKind      kind,
+    const size_t        x,
+    const size_t        y,
+    const size_t        width,
+    const size_t        height,
+    const float*        pixels)
+{
+    // Tiles are written by several render threads.
+    boost::mutex::scoped_lock lock(m_writeMutex);
+
+    // Wait for a free slot.
+    const boost::uint32_t writeIndex = m_header->m_writeIndex.load(boost::memory_order_relaxed);
+    while (writeIndex - m_header->m_readIndex.load(boost::memory_order_acquire) >= m_header->m_slotCount)
+    {
+        if (abortRequested())
+            return false;
+
+        sleepMilliseconds(1);
+    }
+
+    // Edge tiles are never larger than the frame tile size.
+    assert(width * height <= m_header->m_slotPixels);
+
+    unsigned char* p = slot(writeIndex % m_header->m_slotCount);
+    SlotHeader* slotHeader = reinterpret_cast<SlotHeader*>(p);
+    slotHeader->m_kind = kind;
+    slotHeader->m_x = static_cast<boost::uint32_t>(x);
+    slotHeader->m_y = static_cast<boost::uint32_t>(y);
+    slotHeader->m_width = static_cast<boost::uint32_t>(width);
+    slotHeader->m_height = static_cast<boost::uint32_t>(height);
+
+    if (kind == TilePixels)
+        std::memcpy(p + sizeof(SlotHeader), pixels, width * height * 4 * sizeof(float));
+
+    m_header->m_writeIndex.store(writeIndex + 1, boost::memory_order_release);
+    return !abortRequested();
+}
+
+void SharedTileBuffer::setState(const State state)
+{
+    m_header->m_state.store(state, boost::memory_order_release);
+}
+
+bool SharedTileBuffer::abortRequested() const
+{
+    return m_header->m_abort.load(boost::memory_order_acquire) != 0;
+}
+
+bool SharedTileBuffer::readTile(Tile& tile)
+{
+    const boost::uint32_t readIndex = m_header->m_readIndex.load(boost::memory_order_relaxed);
+    if (readIndex == m_header->m_writeIndex.load(boost::memory_order_acquire))
+        return false;
+
+    const unsigned char* p = slot(readIndex % m_header->m_slotCount);
+    const SlotHeader* slotHeader = reinterpret_cast<const SlotHeader*>(p);
+    tile.m_kind = static_cast<TileKind>(slotHeader->m_kind);
+    tile.m_x = slotHeader->m_x;
+    tile.m_y = slotHeader->m_y;
+    tile.m_width = slotHeader->m_width;
+    tile.m_height = slotHeader->m_height;
+
+    if (tile.m_kind == TilePixels)
+    {
+        const size_t count = std::min<size_t>(
+            tile.m_width * tile.m_height,
+            m_header->m_slotPixels) * 4;
+        const float* pixels = reinterpret_cast<const float*>(p + sizeof(SlotHeader));
+        tile.m_pixels.assign(pixels, pixels + count);
+    }
+    else
+        tile.m_pixels.clear();
+
+    m_header->m_readIndex.store(readIndex + 1, boost::memory_order_release);
+    return true;
+}
+
+SharedTileBuffer::State SharedTileBuffer::state() const
+{
+    return static_cast<State>(m_header->m_state.load(boost::memory_order_acquire));
+}
+
+void SharedTileBuffer::requestAbort()
+{
+    m_header->m_abort.store(1, boost::memory_order_release);
+}
+
+unsigned char* SharedTileBuffer::slot(const size_t index) const
+{
+    return static_cast<unsigned char*>(m_address) + sizeof(Header) + index * m_header->m_slotSize;
+}
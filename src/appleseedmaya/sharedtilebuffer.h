@@ -0,0 +1,153 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_MAYA_SHARED_TILE_BUFFER_H
+#define APPLESEED_MAYA_SHARED_TILE_BUFFER_H
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Boost headers.
+#include "boost/noncopyable.hpp"
+#include "boost/thread/mutex.hpp"
+
+//
+// SharedTileBuffer.
+//
+//  Ring buffer of tiles stored in a POSIX shared memory segment.
+//  A render process (producer) writes rendered tiles into it and
+//  Maya (consumer) reads them and displays them in the render view.
+//  The consumer can ask the producer to stop rendering.
+//
+//  This file does not depend on Maya, it is also built into the
+//  appleseedMayaRender executable.
+//
+
+class SharedTileBuffer
+  : boost::noncopyable
+{
+  public:
+    enum State
+    {
+        Rendering,
+        Done,
+        Failed
+    };
+
+    enum TileKind
+    {
+        TileHighlight,  // A tile is about to be rendered, no pixels.
+        TilePixels      // Float RGBA pixels, top to bottom.
+    };
+
+    struct Tile
+    {
+        TileKind            m_kind;
+        size_t              m_x;
+        size_t              m_y;
+        size_t              m_width;
+        size_t              m_height;
+        std::vector<float>  m_pixels;
+    };
+
+    // Create a new shared memory segment. Returns 0 on failure.
+    static SharedTileBuffer* create(
+        const std::string&  name,
+        const size_t        frameWidth,
+        const size_t        frameHeight,
+        const size_t        tileWidth,
+        const size_t        tileHeight,
+        const size_t        slotCount);
+
+    // Open an existing shared memory segment. Returns 0 on failure.
+    static SharedTileBuffer* open(const std::string& name);
+
+    // Unmap the segment. The creator also removes it.
+    ~SharedTileBuffer();
+
+    const std::string& name() const;
+
+    size_t frameWidth() const;
+    size_t frameHeight() const;
+
+    // Producer side. Blocks while the buffer is full.
+    // Returns false if the consumer requested an abort.
+    bool writeHighlight(
+        const size_t        x,
+        const size_t        y,
+        const size_t        width,
+        const size_t        height);
+
+    bool writeTile(
+        const size_t        x,
+        const size_t        y,
+        const size_t        width,
+        const size_t        height,
+        const float*        pixels);
+
+    void setState(const State state);
+
+    bool abortRequested() const;
+
+    // Consumer side. Returns false if there are no tiles available.
+    bool readTile(Tile& tile);
+
+    State state() const;
+
+    void requestAbort();
+
+  private:
+    struct Header;
+
+    SharedTileBuffer(
+        const std::string&  name,
+        void*               address,
+        const size_t        size,
+        const bool          owner);
+
+    bool write(
+        const TileKind      kind,
+        const size_t        x,
+        const size_t        y,
+        const size_t        width,
+        const size_t        height,
+        const float*        pixels);
+
+    unsigned char* slot(const size_t index) const;
+
+    std::string     m_name;
+    void*           m_address;
+    size_t          m_size;
+    bool            m_owner;
+    Header*         m_header;
+    boost::mutex    m_writeMutex;
+};
+
+#endif  // !APPLESEED_MAYA_SHARED_TILE_BUFFER_H
@@ -0,0 +1,207 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "appleseedmaya/swatchcache.h"
+
+// Standard headers.
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <map>
+#include <vector>
+
+// Boost headers.
+#include "boost/filesystem.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
+// Maya headers.
+#include <maya/MImage.h>
+#include <maya/MObject.h>
+#include <maya/MStatus.h>
+
+// appleseed.maya headers.
+#include "appleseedmaya/logger.h"
+#include "appleseedmaya/murmurhash.h"
+#include "appleseedmaya/shadingnetworkhasher.h"
+
+namespace bfs = boost::filesystem;
+
+namespace
+{
+
+// Bump this when the swatch scene changes, to invalidate disk caches.
+const int SwatchCacheVersion = 2;
+
+const size_t MaxCachedSwatches = 1024;
+
+struct CachedSwatch
+{
+    unsigned int                m_width;
+    unsigned int                m_height;
+    std::vector<unsigned char>  m_pixels;
+};
+
+typedef std::map<MurmurHash, CachedSwatch> SwatchMap;
+
+boost::mutex            g_mutex;
+SwatchMap               g_swatches;
+std::list<MurmurHash>   g_insertionOrder;
+bfs::path               g_diskCacheDir;
+
+bfs::path diskCachePath(const MurmurHash& key)
+{
+    return g_diskCacheDir / (key.toString() + ".iff");
+}
+
+void insertInMemory(
+    const MurmurHash&   key,
+    const unsigned int  width,
+    const unsigned int  height,
+    const unsigned char *pixels)
+{
+    boost::lock_guard<boost::mutex> lock(g_mutex);
+
+    if (g_swatches.count(key) != 0)
+        return;
+
+    CachedSwatch& swatch = g_swatches[key];
+    swatch.m_width = width;
+    swatch.m_height = height;
+    swatch.m_pixels.assign(pixels, pixels + width * height * 4);
+    g_insertionOrder.push_back(key);
+
+    // Evict the oldest swatches if needed.
+    while (g_swatches.size() > MaxCachedSwatches)
+    {
+        g_swatches.erase(g_insertionOrder.front());
+        g_insertionOrder.pop_front();
+    }
+}
+
+} // unnamed.
+
+namespace SwatchCache
+{
+
+MStatus initialize()
+{
+    if (const char *cacheDir = getenv("APPLESEED_MAYA_SWATCH_CACHE_DIR"))
+    {
+        try
+        {
+            bfs::create_directories(cacheDir);
+            g_diskCacheDir = cacheDir;
+
+            RENDERER_LOG_INFO(
+                "Using swatch disk cache directory %s.",
+                g_diskCacheDir.string().c_str());
+        }
+        catch(const std::exception& e)
+        {
+            RENDERER_LOG_WARNING(
+                "Could not create swatch cache directory %s: %s.",
+                cacheDir,
+                e.what());
+        }
+    }
+
+    return MS::kSuccess;
+}
+
+MStatus uninitialize()
+{
+    boost::lock_guard<boost::mutex> lock(g_mutex);
+    g_swatches.clear();
+    g_insertionOrder.clear();
+    g_diskCacheDir.clear();
+    return MS::kSuccess;
+}
+
+MurmurHash computeKey(const MObject& node, const int resolution)
+{
+    MurmurHash hash;
+    hash.append(SwatchCacheVersion);
+    hash.append(resolution);
+
+    ShadingNetworkHasher hasher(hash);
+    hasher.hashNode(node);
+    return hash;
+}
+
+bool find(const MurmurHash& key, MImage& image)
+{
+    {
+        boost::lock_guard<boost::mutex> lock(g_mutex);
+
+        SwatchMap::const_iterator it = g_swatches.find(key);
+        if (it != g_swatches.end())
+        {
+            const CachedSwatch& swatch = it->second;
+            image.create(swatch.m_width, swatch.m_height);
+            memcpy(image.pixels(), &swatch.m_pixels[0], swatch.m_pixels.size());
+            return true;
+        }
+    }
+
+    if (g_diskCacheDir.empty())
+        return false;
+
+    const bfs::path path = diskCachePath(key);
+    if (!bfs::exists(path))
+        return false;
+
+    if (!image.readFromFile(path.string().c_str()))
+        return false;
+
+    unsigned int width, height;
+    image.getSize(width, height);
+    insertInMemory(key, width, height, image.pixels());
+    return true;
+}
+
+void insert(const MurmurHash& key, MImage& image)
+{
+    unsigned int width, height;
+    image.getSize(width, height);
+    insertInMemory(key, width, height, image.pixels());
+
+    if (!g_diskCacheDir.empty())
+    {
+        const bfs::path path = diskCachePath(key);
+        if (!image.writeToFile(path.string().c_str()))
+        {
+            RENDERER_LOG_DEBUG(
+                "Could not write swatch cache file %s.",
+                path.string().c_str());
+        }
+    }
+}
+
+} // namespace SwatchCache.
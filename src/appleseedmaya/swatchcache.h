@@ -0,0 +1,65 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_MAYA_SWATCH_CACHE_H
+#define APPLESEED_MAYA_SWATCH_CACHE_H
+
+// Forward declarations.
+class MImage;
+class MObject;
+class MStatus;
+class MurmurHash;
+
+//
+// SwatchCache.
+//
+//  Cache of rendered swatch images, keyed by a hash of the shading network
+//  topology, its parameter values, the modification time of the files they
+//  name and the swatch resolution.
+//  Images are kept in memory and, if the APPLESEED_MAYA_SWATCH_CACHE_DIR
+//  environment variable is set, written to and read from that directory.
+//
+
+namespace SwatchCache
+{
+
+MStatus initialize();
+MStatus uninitialize();
+
+// Compute the cache key for the shading network rooted at node.
+MurmurHash computeKey(const MObject& node, const int resolution);
+
+// Copy a cached image into image, if there is one. Return true on success.
+bool find(const MurmurHash& key, MImage& image);
+
+// Add an image to the cache.
+void insert(const MurmurHash& key, MImage& image);
+
+} // namespace SwatchCache.
+
+#endif  // !APPLESEED_MAYA_SWATCH_CACHE_H
@@ -29,11 +29,28 @@
 // Interface header.
 #include "appleseedmaya/swatchrenderer.h"
 
+// Standard headers.
+#include <cstring>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+// Boost headers.
+#include "boost/bind.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/thread.hpp"
+
 // Maya headers.
 #include <maya/MFnDependencyNode.h>
 #include <maya/MImage.h>
+#include <maya/MPlug.h>
 
 // appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
 #include "foundation/math/vector.h"
 #include "foundation/utility/iostreamop.h"
 
@@ -49,21 +66,361 @@
 #include "renderer/api/project.h"
 #include "renderer/api/rendering.h"
 #include "renderer/api/scene.h"
+#include "renderer/api/shadergroup.h"
 
 // appleseed.maya headers.
+#include "appleseedmaya/appleseedsession.h"
+#include "appleseedmaya/exporters/exporterfactory.h"
+#include "appleseedmaya/exporters/shadingnetworkexporter.h"
 #include "appleseedmaya/imageutils.h"
 #include "appleseedmaya/logger.h"
+#include "appleseedmaya/murmurhash.h"
+#include "appleseedmaya/renderercontroller.h"
+#include "appleseedmaya/shadingnodemetadata.h"
+#include "appleseedmaya/shadingnoderegistry.h"
+#include "appleseedmaya/swatchcache.h"
+#include "appleseedmaya/utils.h"
 
 namespace asf = foundation;
 namespace asr = renderer;
 
+//
+// SwatchRenderRequest.
+//
+//  A swatch render, created in the main thread and rendered in the swatch worker thread.
+//
+
+class SwatchRenderRequest
+  : NonCopyable
+{
+  public:
+    SwatchRenderRequest(
+        const MString&      nodeName,
+        const MurmurHash&   key,
+        const int           resolution,
+        const size_t        numThreads)
+      : m_nodeName(nodeName)
+      , m_key(key)
+      , m_resolution(resolution)
+      , m_numThreads(numThreads)
+      , m_serial(0)
+      , m_done(false)
+      , m_cached(false)
+    {
+    }
+
+    const MString                               m_nodeName;
+    const MurmurHash                            m_key;
+    const int                                   m_resolution;
+    const size_t                                m_numThreads;
+    size_t                                      m_serial;
+    asf::auto_release_ptr<asr::ShaderGroup>     m_shaderGroup;
+
+    // Protected by the swatch queue mutex.
+    bool                                        m_done;
+    std::vector<unsigned char>                  m_pixels;
+    SwatchRenderRequestPtr                      m_supersededBy;
+
+    // Only accessed from the main thread.
+    bool                                        m_cached;
+};
+
 namespace
 {
+
 asf::auto_release_ptr<asr::Project> g_project;
 asr::Assembly*                      g_mainAssembly;
 asr::Material*                      g_material;
 asr::MasterRenderer*                g_renderer;
-asr::DefaultRendererController      g_rendererController;
+RendererController                  g_rendererController;
+
+// Return the first closure output of a shading node, if any.
+bool findSurfaceOutputPlug(const MObject& node, MPlug& outputPlug)
+{
+    MFnDependencyNode depNodeFn(node);
+    const OSLShaderInfo *shaderInfo = ShadingNodeRegistry::getShaderInfo(depNodeFn.typeName());
+    if (shaderInfo == 0)
+        return false;
+
+    for(size_t i = 0, e = shaderInfo->paramInfo.size(); i < e; ++i)
+    {
+        const OSLParamInfo& paramInfo = shaderInfo->paramInfo[i];
+        if (paramInfo.isOutput && paramInfo.isClosure)
+        {
+            MStatus status;
+            outputPlug = depNodeFn.findPlug(paramInfo.mayaAttributeName, &status);
+            return status == MS::kSuccess;
+        }
+    }
+
+    return false;
+}
+
+// Number of threads to use for swatch renders.
+size_t swatchRenderThreadCount()
+{
+    // Stay out of the way of final and interactive renders.
+    const AppleseedSession::SessionMode mode = AppleseedSession::sessionMode();
+    if (mode == AppleseedSession::FinalRenderSession ||
+        mode == AppleseedSession::ProgressiveRenderSession)
+    {
+        return 1;
+    }
+
+    // Otherwise, use all the cores but one, to keep Maya responsive.
+    const size_t numCores = boost::thread::hardware_concurrency();
+    return numCores > 1 ? numCores - 1 : 1;
+}
+
+// Export the shading network of a node into a request.
+// Must be called from the main thread.
+void exportShadingNetwork(const MObject& node, SwatchRenderRequest& request)
+{
+    MPlug outputPlug;
+    if (!findSurfaceOutputPlug(node, outputPlug))
+        return;
+
+    // Export into a temporary assembly, the swatch project is owned by the worker thread.
+    asf::auto_release_ptr<asr::Assembly> assembly(
+        asr::AssemblyFactory().create("swatch_assembly", asr::ParamArray()));
+
+    ShadingNetworkExporterPtr networkExporter(
+        NodeExporterFactory::createShadingNetworkExporter(
+            SurfaceNetworkContext,
+            node,
+            outputPlug,
+            *assembly,
+            AppleseedSession::FinalRenderSession));
+
+    networkExporter->createEntities();
+    networkExporter->flushEntities();
+
+    asr::ShaderGroupContainer& shaderGroups = assembly->shader_groups();
+    request.m_shaderGroup = shaderGroups.remove(
+        shaderGroups.get_by_name(networkExporter->shaderGroupName().asChar()));
+}
+
+//
+// SwatchRenderQueue.
+//
+//  Renders swatches in a background thread.
+//  Newer requests are rendered first, as they are most likely visible.
+//  A new request for a node supersedes the pending request for the same node
+//  and resolution. Maya requests several sizes of the same swatch.
+//
+
+class SwatchRenderQueue
+  : NonCopyable
+{
+  public:
+    SwatchRenderQueue()
+      : m_nextSerial(0)
+      , m_stop(false)
+    {
+    }
+
+    void start()
+    {
+        m_stop = false;
+        m_thread = boost::thread(boost::bind(&SwatchRenderQueue::run, this));
+    }
+
+    void stop()
+    {
+        {
+            boost::lock_guard<boost::mutex> lock(m_mutex);
+            m_stop = true;
+            m_pending.clear();
+            m_pendingByNode.clear();
+            g_rendererController.set_status(asr::IRendererController::AbortRendering);
+        }
+
+        m_cond.notify_one();
+        m_thread.join();
+    }
+
+    void push(const SwatchRenderRequestPtr& request)
+    {
+        {
+            boost::lock_guard<boost::mutex> lock(m_mutex);
+
+            request->m_serial = m_nextSerial++;
+
+            // Drop the pending request for the same node and resolution, if any.
+            const NodeRequestKey key(request->m_nodeName, request->m_resolution);
+            NodeRequestMap::iterator it = m_pendingByNode.find(key);
+            if (it != m_pendingByNode.end())
+            {
+                it->second->m_supersededBy = request;
+                m_pending.erase(it->second->m_serial);
+                m_pendingByNode.erase(it);
+            }
+
+            // Abort the current render if it is for the same node and resolution.
+            if (m_current &&
+                m_current->m_nodeName == request->m_nodeName &&
+                m_current->m_resolution == request->m_resolution)
+            {
+                m_current->m_supersededBy = request;
+                g_rendererController.set_status(asr::IRendererController::AbortRendering);
+            }
+
+            m_pending[request->m_serial] = request;
+            m_pendingByNode[key] = request;
+        }
+
+        m_cond.notify_one();
+    }
+
+    // Return the request that replaced this one, or the request itself.
+    SwatchRenderRequestPtr latest(SwatchRenderRequestPtr request)
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+
+        while (request->m_supersededBy)
+            request = request->m_supersededBy;
+
+        return request;
+    }
+
+    bool isDone(const SwatchRenderRequestPtr& request)
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        return request->m_done && !request->m_supersededBy;
+    }
+
+  private:
+    typedef std::map<size_t, SwatchRenderRequestPtr, std::greater<size_t> > RequestMap;
+    typedef std::pair<MString, int> NodeRequestKey;
+
+    struct NodeRequestKeyLess
+    {
+        bool operator()(const NodeRequestKey& a, const NodeRequestKey& b) const
+        {
+            if (a.second != b.second)
+                return a.second < b.second;
+
+            return MStringCompareLess()(a.first, b.first);
+        }
+    };
+
+    typedef std::map<NodeRequestKey, SwatchRenderRequestPtr, NodeRequestKeyLess> NodeRequestMap;
+
+    void run()
+    {
+        while (true)
+        {
+            SwatchRenderRequestPtr request;
+
+            {
+                boost::unique_lock<boost::mutex> lock(m_mutex);
+
+                while (!m_stop && m_pending.empty())
+                    m_cond.wait(lock);
+
+                if (m_stop)
+                    return;
+
+                request = m_pending.begin()->second;
+                m_pending.erase(m_pending.begin());
+                m_pendingByNode.erase(NodeRequestKey(request->m_nodeName, request->m_resolution));
+
+                m_current = request;
+                g_rendererController.set_status(asr::IRendererController::ContinueRendering);
+            }
+
+            std::vector<unsigned char> pixels;
+
+            try
+            {
+                render(*request, pixels);
+            }
+            catch(const std::exception& e)
+            {
+                RENDERER_LOG_ERROR("Swatch render failed: %s.", e.what());
+            }
+
+            {
+                boost::lock_guard<boost::mutex> lock(m_mutex);
+
+                if (!request->m_supersededBy)
+                    request->m_pixels.swap(pixels);
+
+                request->m_done = true;
+                m_current.reset();
+            }
+        }
+    }
+
+    void render(SwatchRenderRequest& request, std::vector<unsigned char>& pixels)
+    {
+        // Disable logging while rendering the swatch.
+        ScopedSetLoggerVerbosity logLevel(asf::LogMessage::Error);
+
+        // Remove all shadergroups.
+        g_mainAssembly->shader_groups().clear();
+        g_material->get_parameters().remove_path("osl_surface");
+
+        // Nodes without a closure output, such as textures and utilities,
+        // are shown with a facing ratio shading of the swatch geometry.
+        if (request.m_shaderGroup.get())
+        {
+            g_material->get_parameters().insert(
+                "osl_surface",
+                request.m_shaderGroup->get_name());
+            g_mainAssembly->shader_groups().insert(request.m_shaderGroup);
+            g_renderer->get_parameters().remove_path("shading_engine.override_shading");
+        }
+        else
+        {
+            g_renderer->get_parameters().insert_path(
+                "shading_engine.override_shading.mode",
+                "facing_ratio");
+        }
+
+        // Reuse the frame if the resolution did not change.
+        const size_t resolution = static_cast<size_t>(request.m_resolution);
+        const asf::CanvasProperties& props = g_project->get_frame()->image().properties();
+        if (props.m_canvas_width == resolution && props.m_canvas_height == resolution)
+        {
+            g_project->get_frame()->clear_main_and_aov_images();
+        }
+        else
+        {
+            asr::ParamArray frameParams = g_project->get_frame()->get_parameters();
+            frameParams.insert("resolution", asf::Vector2i(request.m_resolution, request.m_resolution));
+            asf::auto_release_ptr<asr::Frame> frame(asr::FrameFactory::create("beauty", frameParams));
+            g_project->set_frame(frame);
+        }
+
+        g_renderer->get_parameters().insert("rendering_threads", request.m_numThreads);
+        g_renderer->render();
+
+        if (g_rendererController.get_status() == asr::IRendererController::AbortRendering)
+            return;
+
+        // The frame is reused by the next render and the swatch MImage belongs
+        // to the main thread, so the pixels are swizzled into the request here,
+        // leaving only a memcpy to the main thread.
+        pixels.resize(request.m_resolution * request.m_resolution * 4);
+        ImageUtils::copySwatchImage(
+            g_project->get_frame()->image(),
+            &pixels[0],
+            request.m_resolution,
+            request.m_resolution);
+    }
+
+    boost::mutex                m_mutex;
+    boost::condition_variable   m_cond;
+    RequestMap                  m_pending;
+    NodeRequestMap              m_pendingByNode;
+    SwatchRenderRequestPtr      m_current;
+    size_t                      m_nextSerial;
+    bool                        m_stop;
+    boost::thread               m_thread;
+};
+
+SwatchRenderQueue g_renderQueue;
 
 }
 
@@ -77,8 +434,6 @@ void SwatchRenderer::initialize()
     g_project = asr::ProjectFactory::create("project");
     g_project->add_default_configurations();
 
-    const size_t NumThreads = 2;
-
     // Insert some config params needed by the interactive renderer.
     asr::Configuration *cfg = g_project->configurations().get_by_name("interactive");
     asr::ParamArray *cfg_params = &cfg->get_parameters();
@@ -90,7 +445,6 @@ void SwatchRenderer::initialize()
     cfg_params->insert("pixel_renderer", "uniform");
     cfg_params->insert("sampling_mode", "qmc");
     cfg_params->insert_path("progressive_frame_renderer.max_fps", "5");
-    cfg_params->insert("rendering_threads", NumThreads);
 
     // Insert some config params needed by the final renderer.
     cfg = g_project->configurations().get_by_name("final");
@@ -103,7 +457,6 @@ void SwatchRenderer::initialize()
     cfg_params->insert("pixel_renderer", "uniform");
     cfg_params->insert("sampling_mode", "qmc");
     cfg_params->insert_path("uniform_pixel_renderer.samples", "4");
-    cfg_params->insert("rendering_threads", NumThreads);
 
     // Create some basic project entities.
 
@@ -197,11 +550,6 @@ void SwatchRenderer::initialize()
     asf::auto_release_ptr<asr::AssemblyInstance> assemblyInstance = asr::AssemblyInstanceFactory::create("assembly_inst", asr::ParamArray(), "assembly");
     g_project->get_scene()->assembly_instances().insert(assemblyInstance);
 
-    // While testing...
-    cfg_params->insert_path(
-        "shading_engine.override_shading.mode",
-        "facing_ratio");
-
     // Create the master renderer.
     g_renderer =
         new asr::MasterRenderer(
@@ -209,11 +557,17 @@ void SwatchRenderer::initialize()
             g_project->configurations().get_by_name("final")->get_inherited_parameters(),
             &g_rendererController);
 
+    g_renderQueue.start();
+    SwatchCache::initialize();
+
     RENDERER_LOG_INFO("Initialized swatch renderer.");
 }
 
 void SwatchRenderer::uninitialize()
 {
+    g_renderQueue.stop();
+    SwatchCache::uninitialize();
+
     delete g_renderer;
     g_project.reset();
     RENDERER_LOG_INFO("Uninitialized swatch renderer.");
@@ -237,37 +591,54 @@ SwatchRenderer::SwatchRenderer(
 
 bool SwatchRenderer::doIteration()
 {
-    MFnDependencyNode depNodeFn(node());
-    const MString name = depNodeFn.name();
-    const MString typeName = depNodeFn.typeName();
-    const MString classification = MFnDependencyNode::classification(typeName);
-
-    RENDERER_LOG_DEBUG(
-        "Rendering swatch for node %s of type %s and classification %s. res = %d",
-        name.asChar(),
-        typeName.asChar(),
-        classification.asChar(),
-        resolution());
-
-    // Disable logging while rendering the swatch.
-    ScopedSetLoggerVerbosity logLevel(asf::LogMessage::Error);
-
-    // Remove all shadergroups.
-    g_mainAssembly->shader_groups().clear();
-    g_material->get_parameters().remove_path("osl_surface");
-
-    // todo: export node() here...
-
-    image().create(resolution(), resolution());
-
-    // Recreate the frame.
-    asr::ParamArray frameParams = g_project->get_frame()->get_parameters();
-    frameParams.insert("resolution", asf::Vector2i(resolution(), resolution()));
-    asf::auto_release_ptr<asr::Frame> frame(asr::FrameFactory::create("beauty", frameParams));
-    g_project->set_frame(frame);
-
-    g_renderer->render();
+    if (!m_request)
+    {
+        MFnDependencyNode depNodeFn(node());
+        const MString name = depNodeFn.name();
+        const MString typeName = depNodeFn.typeName();
+        const MString classification = MFnDependencyNode::classification(typeName);
+
+        RENDERER_LOG_DEBUG(
+            "Rendering swatch for node %s of type %s and classification %s. res = %d",
+            name.asChar(),
+            typeName.asChar(),
+            classification.asChar(),
+            resolution());
+
+        // Reuse a previous render of an identical shading network if possible.
+        const MurmurHash key = SwatchCache::computeKey(node(), resolution());
+        if (SwatchCache::find(key, image()))
+            return true;
+
+        m_request.reset(
+            new SwatchRenderRequest(
+                name,
+                key,
+                resolution(),
+                swatchRenderThreadCount()));
+        exportShadingNetwork(node(), *m_request);
+        g_renderQueue.push(m_request);
+        return false;
+    }
+
+    // Follow the requests that superseded ours.
+    m_request = g_renderQueue.latest(m_request);
+
+    if (!g_renderQueue.isDone(m_request))
+        return false;
+
+    image().create(m_request->m_resolution, m_request->m_resolution);
+
+    if (!m_request->m_pixels.empty())
+    {
+        memcpy(image().pixels(), &m_request->m_pixels[0], m_request->m_pixels.size());
+
+        if (!m_request->m_cached)
+        {
+            SwatchCache::insert(m_request->m_key, image());
+            m_request->m_cached = true;
+        }
+    }
 
-    ImageUtils::copySwatchImage(g_project->get_frame()->image(), image());
     return true;
 }
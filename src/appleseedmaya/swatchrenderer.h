@@ -29,9 +29,16 @@
 #ifndef APPLESEED_MAYA_SWATCH_RENDERER_H
 #define APPLESEED_MAYA_SWATCH_RENDERER_H
 
+// Boost headers.
+#include "boost/shared_ptr.hpp"
+
 // Maya headers.
 #include <maya/MSwatchRenderBase.h>
 
+// Forward declarations.
+class SwatchRenderRequest;
+typedef boost::shared_ptr<SwatchRenderRequest> SwatchRenderRequestPtr;
+
 class SwatchRenderer
   : public MSwatchRenderBase
 {
@@ -52,7 +59,11 @@ class SwatchRenderer
         MObject renderNode,
         int     imageResolution);
 
+    // Return false until the swatch has been rendered in the background.
     virtual bool doIteration();
+
+  private:
+    SwatchRenderRequestPtr m_request;
 };
 
 #endif  // !APPLESEED_MAYA_SWATCH_RENDERER_H
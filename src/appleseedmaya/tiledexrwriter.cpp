@@ -0,0 +1,457 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "appleseedmaya/tiledexrwriter.h"
+
+// Standard headers.
+#include <algorithm>
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
+#include "foundation/image/tile.h"
+#include "foundation/utility/string.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/frame.h"
+#include "renderer/api/log.h"
+
+namespace asf = foundation;
+namespace asr = renderer;
+
+namespace
+{
+
+void addLayerChannels(
+    const std::string&          layerName,
+    const size_t                channelCount,
+    std::vector<std::string>&   channelNames)
+{
+    const char* channels[] = { "R", "G", "B", "A" };
+
+    for (size_t i = 0; i < channelCount; ++i)
+    {
+        const std::string channel = i < 4 ? channels[i] : asf::to_string(i);
+        channelNames.push_back(layerName.empty() ? channel : layerName + "." + channel);
+    }
+}
+
+// Name of the layer of an AOV image, without the "_aov" suffix.
+std::string layerName(const char* aovName)
+{
+    std::string name(aovName);
+
+    if (asf::ends_with(name, "_aov"))
+        name.erase(name.size() - 4);
+
+    return name;
+}
+
+// Copy a tile into the channels [channelOffset, channelOffset + tile channels)
+// of a buffer with channelCount interleaved channels and rows of rowWidth pixels.
+void copyLayer(
+    const asf::Tile&    tile,
+    const size_t        rowWidth,
+    const size_t        channelCount,
+    const size_t        channelOffset,
+    float*              dst)
+{
+    for (size_t y = 0, h = tile.get_height(); y < h; ++y)
+    {
+        float* p = dst + (y * rowWidth) * channelCount + channelOffset;
+
+        for (size_t x = 0, w = tile.get_width(); x < w; ++x, p += channelCount)
+            tile.get_pixel(x, y, p);
+    }
+}
+
+// Copy a tile of all the layers of a frame.
+void copyTilePixels(
+    const asr::Frame&   frame,
+    const size_t        tileX,
+    const size_t        tileY,
+    const size_t        rowWidth,
+    const size_t        channelCount,
+    float*              dst)
+{
+    const asr::ImageStack& aovImages = frame.aov_images();
+
+    copyLayer(frame.image().tile(tileX, tileY), rowWidth, channelCount, 0, dst);
+    size_t channelOffset = frame.image().properties().m_channel_count;
+
+    for (size_t i = 0, e = aovImages.size(); i < e; ++i)
+    {
+        const asf::Image& image = aovImages.get_image(i);
+        copyLayer(image.tile(tileX, tileY), rowWidth, channelCount, channelOffset, dst);
+        channelOffset += image.properties().m_channel_count;
+    }
+}
+
+// Copy all the layers of a frame into a buffer of whole rows.
+void copyFramePixels(
+    const asr::Frame&   frame,
+    const size_t        channelCount,
+    float*              dst)
+{
+    const asf::CanvasProperties& props = frame.image().properties();
+
+    for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+    {
+        for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
+        {
+            const size_t x = tx * props.m_tile_width;
+            const size_t y = ty * props.m_tile_height;
+
+            copyTilePixels(
+                frame,
+                tx,
+                ty,
+                props.m_canvas_width,
+                channelCount,
+                dst + (y * props.m_canvas_width + x) * channelCount);
+        }
+    }
+}
+
+// Image spec of a multi-layer file, one layer per image, the main image is the default layer.
+OIIO::ImageSpec frameImageSpec(const asr::Frame& frame, const ExrWriteOptions& options)
+{
+    const asf::CanvasProperties& props = frame.image().properties();
+    const asr::ImageStack& aovImages = frame.aov_images();
+
+    std::vector<std::string> channelNames;
+    addLayerChannels(std::string(), props.m_channel_count, channelNames);
+
+    for (size_t i = 0, e = aovImages.size(); i < e; ++i)
+    {
+        addLayerChannels(
+            layerName(aovImages.get_name(i)),
+            aovImages.get_image(i).properties().m_channel_count,
+            channelNames);
+    }
+
+    OIIO::ImageSpec spec(
+        static_cast<int>(props.m_canvas_width),
+        static_cast<int>(props.m_canvas_height),
+        static_cast<int>(channelNames.size()),
+        props.m_pixel_format == asf::PixelFormatHalf ? OIIO::TypeDesc::HALF : OIIO::TypeDesc::FLOAT);
+
+    spec.channelnames = channelNames;
+    spec.alpha_channel = props.m_channel_count == 4 ? 3 : -1;
+    spec.attribute("compression", options.m_compression);
+
+    if (options.m_tiled)
+    {
+        spec.tile_width = static_cast<int>(props.m_tile_width);
+        spec.tile_height = static_cast<int>(props.m_tile_height);
+        spec.attribute("openexr:lineOrder", "randomY");
+    }
+
+    return spec;
+}
+
+// Let OpenEXR compress with all the available cores.
+void enableExrThreads()
+{
+    OIIO::attribute("exr_threads", static_cast<int>(boost::thread::hardware_concurrency()));
+}
+
+class TiledExrWriterTileCallback
+  : public asr::ITileCallback
+{
+  public:
+    explicit TiledExrWriterTileCallback(TiledExrWriter& writer)
+      : m_writer(writer)
+    {
+    }
+
+    virtual void release()
+    {
+        delete this;
+    }
+
+    virtual void pre_render(
+        const size_t        x,
+        const size_t        y,
+        const size_t        width,
+        const size_t        height)
+    {
+    }
+
+    virtual void post_render(
+        const asr::Frame*   frame)
+    {
+    }
+
+    virtual void post_render_tile(
+        const asr::Frame*   frame,
+        const size_t        tile_x,
+        const size_t        tile_y)
+    {
+        m_writer.writeTile(*frame, tile_x, tile_y);
+    }
+
+  private:
+    TiledExrWriter& m_writer;
+};
+
+} // unnamed.
+
+ExrWriteOptions::ExrWriteOptions()
+  : m_compression("zip")
+  , m_tiled(true)
+{
+}
+
+TiledExrWriter::TiledExrWriter()
+  : m_channelCount(0)
+  , m_tiled(true)
+  , m_failed(false)
+{
+}
+
+TiledExrWriter::~TiledExrWriter()
+{
+    if (m_output)
+        m_output->close();
+}
+
+bool TiledExrWriter::open(
+    const std::string&      fileName,
+    const renderer::Frame&  frame,
+    const ExrWriteOptions&  options)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    if (m_output)
+        m_output->close();
+
+    enableExrThreads();
+
+    const OIIO::ImageSpec spec = frameImageSpec(frame, options);
+    m_output.reset(OIIO::ImageOutput::create(fileName));
+
+    if (!m_output || (options.m_tiled && !m_output->supports("tiles")) || !m_output->open(fileName, spec))
+    {
+        RENDERER_LOG_ERROR(
+            "appleseedMaya: could not open %s for writing: %s",
+            fileName.c_str(),
+            m_output ? m_output->geterror().c_str() : OIIO::geterror().c_str());
+
+        m_output.reset();
+        return false;
+    }
+
+    m_fileName = fileName;
+    m_channelCount = spec.nchannels;
+    m_tiled = options.m_tiled;
+    m_writtenTiles.assign(frame.image().properties().m_tile_count, false);
+    m_failed = false;
+    return true;
+}
+
+bool TiledExrWriter::isOpen() const
+{
+    return m_output.get() != 0;
+}
+
+void TiledExrWriter::writeTile(const renderer::Frame& frame, const size_t tileX, const size_t tileY)
+{
+    const asf::CanvasProperties& props = frame.image().properties();
+    const size_t tileIndex = tileY * props.m_tile_count_x + tileX;
+
+    size_t channelCount;
+
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        if (!m_output || !m_tiled || m_writtenTiles[tileIndex])
+            return;
+
+        m_writtenTiles[tileIndex] = true;
+        channelCount = m_channelCount;
+    }
+
+    // Gather the layers outside of the lock, only writing the tile is serialized.
+    std::vector<float> pixels(props.m_tile_width * props.m_tile_height * channelCount, 0.0f);
+    copyTilePixels(frame, tileX, tileY, props.m_tile_width, channelCount, &pixels[0]);
+
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    if (m_output &&
+        !m_output->write_tile(
+            static_cast<int>(tileX * props.m_tile_width),
+            static_cast<int>(tileY * props.m_tile_height),
+            0,
+            OIIO::TypeDesc::FLOAT,
+            &pixels[0]))
+    {
+        if (!m_failed)
+        {
+            RENDERER_LOG_ERROR(
+                "appleseedMaya: could not write tile to %s: %s",
+                m_fileName.c_str(),
+                m_output->geterror().c_str());
+        }
+
+        m_failed = true;
+    }
+}
+
+bool TiledExrWriter::close(const renderer::Frame& frame)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    if (!m_output)
+        return false;
+
+    const asf::CanvasProperties& props = frame.image().properties();
+
+    if (m_tiled)
+    {
+        std::vector<float> pixels(props.m_tile_width * props.m_tile_height * m_channelCount);
+
+        // Write the tiles that were not rendered, for example outside of the crop window.
+        for (size_t ty = 0; ty < props.m_tile_count_y && !m_failed; ++ty)
+        {
+            for (size_t tx = 0; tx < props.m_tile_count_x && !m_failed; ++tx)
+            {
+                const size_t tileIndex = ty * props.m_tile_count_x + tx;
+                if (m_writtenTiles[tileIndex])
+                    continue;
+
+                std::fill(pixels.begin(), pixels.end(), 0.0f);
+                copyTilePixels(frame, tx, ty, props.m_tile_width, m_channelCount, &pixels[0]);
+
+                m_failed = !m_output->write_tile(
+                    static_cast<int>(tx * props.m_tile_width),
+                    static_cast<int>(ty * props.m_tile_height),
+                    0,
+                    OIIO::TypeDesc::FLOAT,
+                    &pixels[0]);
+
+                m_writtenTiles[tileIndex] = true;
+            }
+        }
+    }
+    else
+    {
+        std::vector<float> pixels(props.m_pixel_count * m_channelCount);
+        copyFramePixels(frame, m_channelCount, &pixels[0]);
+        m_failed = !m_output->write_image(OIIO::TypeDesc::FLOAT, &pixels[0]);
+    }
+
+    const bool succeeded = m_output->close() && !m_failed;
+
+    if (!succeeded)
+    {
+        RENDERER_LOG_ERROR(
+            "appleseedMaya: could not write %s: %s",
+            m_fileName.c_str(),
+            m_output->geterror().c_str());
+    }
+
+    m_output.reset();
+    return succeeded;
+}
+
+AsyncExrWriter::AsyncExrWriter()
+  : m_failed(false)
+{
+}
+
+AsyncExrWriter::~AsyncExrWriter()
+{
+    wait();
+}
+
+void AsyncExrWriter::write(
+    const std::string&      fileName,
+    const renderer::Frame&  frame,
+    const ExrWriteOptions&  options)
+{
+    wait();
+
+    enableExrThreads();
+
+    m_fileName = fileName;
+    m_spec = frameImageSpec(frame, options);
+    m_pixels.resize(frame.image().properties().m_pixel_count * m_spec.nchannels);
+    copyFramePixels(frame, m_spec.nchannels, &m_pixels[0]);
+    m_failed = false;
+
+    boost::thread thread(&AsyncExrWriter::writeFunc, this);
+    m_thread.swap(thread);
+}
+
+bool AsyncExrWriter::wait()
+{
+    if (m_thread.joinable())
+        m_thread.join();
+
+    return !m_failed;
+}
+
+void AsyncExrWriter::writeFunc()
+{
+    boost::scoped_ptr<OIIO::ImageOutput> output(OIIO::ImageOutput::create(m_fileName));
+
+    m_failed =
+        !output ||
+        !output->open(m_fileName, m_spec) ||
+        !output->write_image(OIIO::TypeDesc::FLOAT, &m_pixels[0]) ||
+        !output->close();
+
+    if (m_failed)
+    {
+        RENDERER_LOG_ERROR(
+            "appleseedMaya: could not write %s: %s",
+            m_fileName.c_str(),
+            output ? output->geterror().c_str() : OIIO::geterror().c_str());
+    }
+
+    // Release the frame copy.
+    std::vector<float>().swap(m_pixels);
+}
+
+TiledExrWriterTileCallbackFactory::TiledExrWriterTileCallbackFactory(TiledExrWriter& writer)
+  : m_writer(writer)
+{
+}
+
+void TiledExrWriterTileCallbackFactory::release()
+{
+    delete this;
+}
+
+renderer::ITileCallback* TiledExrWriterTileCallbackFactory::create()
+{
+    return new TiledExrWriterTileCallback(m_writer);
+}
@@ -0,0 +1,165 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_MAYA_TILED_EXR_WRITER_H
+#define APPLESEED_MAYA_TILED_EXR_WRITER_H
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Boost headers.
+#include "boost/noncopyable.hpp"
+#include "boost/scoped_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/thread.hpp"
+
+// OpenImageIO headers.
+#include "OpenImageIO/imageio.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/rendering.h"
+
+// Forward declarations.
+namespace renderer { class Frame; }
+
+//
+// OpenEXR output of frames.
+//
+//  The main image and the AOVs of a frame are written into a single
+//  multi-layer OpenEXR file.
+//
+//  This file does not depend on Maya, it is also built into the
+//  appleseedMayaRender executable.
+//
+
+struct ExrWriteOptions
+{
+    ExrWriteOptions();
+
+    std::string m_compression;  // OpenEXR compression: none, zip, piz or dwaa.
+    bool        m_tiled;        // Tiled or scanline file.
+};
+
+//
+// TiledExrWriter.
+//
+//  Writes a frame one tile at a time, as tiles are rendered. Tiles are
+//  written in random order, so OpenEXR does not buffer them. Scanline
+//  files can't be written in random order, they are written on close.
+//
+
+class TiledExrWriter
+  : boost::noncopyable
+{
+  public:
+    TiledExrWriter();
+    ~TiledExrWriter();
+
+    // Open a file for the frame. Returns false on failure.
+    bool open(
+        const std::string&      fileName,
+        const renderer::Frame&  frame,
+        const ExrWriteOptions&  options = ExrWriteOptions());
+
+    bool isOpen() const;
+
+    // Write a tile of all the layers of the frame. Tiles are written only once.
+    // Does nothing if the file is not open. Thread safe.
+    void writeTile(const renderer::Frame& frame, const size_t tileX, const size_t tileY);
+
+    // Write the tiles not written yet and close the file. Returns false on failure.
+    bool close(const renderer::Frame& frame);
+
+  private:
+    boost::mutex                            m_mutex;
+    boost::scoped_ptr<OIIO::ImageOutput>    m_output;
+    std::string                             m_fileName;
+    size_t                                  m_channelCount;
+    bool                                    m_tiled;
+    std::vector<bool>                       m_writtenTiles;
+    bool                                    m_failed;
+};
+
+//
+// AsyncExrWriter.
+//
+//  Copies the pixels of a frame and writes them in a background thread,
+//  so that rendering can continue while the file is compressed.
+//  OpenEXR compresses with all the available cores.
+//
+
+class AsyncExrWriter
+  : boost::noncopyable
+{
+  public:
+    AsyncExrWriter();
+
+    // Waits for the pending write.
+    ~AsyncExrWriter();
+
+    // Start writing a frame. Waits for the previous write first,
+    // so that at most one copy of a frame is kept in memory.
+    void write(
+        const std::string&      fileName,
+        const renderer::Frame&  frame,
+        const ExrWriteOptions&  options = ExrWriteOptions());
+
+    // Wait for the pending write. Returns false if it failed.
+    bool wait();
+
+  private:
+    void writeFunc();
+
+    boost::thread                           m_thread;
+    std::string                             m_fileName;
+    OIIO::ImageSpec                         m_spec;
+    std::vector<float>                      m_pixels;
+    bool                                    m_failed;
+};
+
+//
+// Tile callback factory streaming the tiles rendered by a master renderer to a TiledExrWriter.
+//
+
+class TiledExrWriterTileCallbackFactory
+  : public renderer::ITileCallbackFactory
+{
+  public:
+    explicit TiledExrWriterTileCallbackFactory(TiledExrWriter& writer);
+
+    virtual void release();
+
+    virtual renderer::ITileCallback* create();
+
+  private:
+    TiledExrWriter& m_writer;
+};
+
+#endif  // !APPLESEED_MAYA_TILED_EXR_WRITER_H
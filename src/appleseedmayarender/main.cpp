@@ -0,0 +1,440 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//
+// appleseedMayaRender.
+//
+//  Renders a project written by appleseedMaya in a separate process.
+//
+//  Usage: appleseedMayaRender project.appleseed [--shm name] [--output file] [--schema file]
+//                                                [--crop xmin ymin xmax ymax] [--threads n] [--cpus list]
+//                                                [--time-limit seconds]
+//
+//  --shm       name of the shared memory tile buffer created by appleseedMaya.
+//  --output    write the main image and the AOVs to this file when rendering is done.
+//              OpenEXR files are written as a single multi-layer file.
+//  --schema    path to the appleseed project schema. Defaults to schemas/project.xsd
+//              next to the executable, where the build copies it.
+//  --crop      only render this window of the frame, in pixels, inclusive.
+//  --threads   number of rendering threads.
+//  --cpus      restrict the process to a list of CPUs, for example "0-7,16-23".
+//  --time-limit
+//              stop rendering after this many seconds and keep the rendered image.
+//
+
+// Standard headers.
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+// Boost headers.
+#include "boost/cstdint.hpp"
+#include "boost/filesystem/path.hpp"
+#include "boost/filesystem/operations.hpp"
+#include "boost/scoped_ptr.hpp"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
+#include "foundation/image/tile.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/defaulttimers.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/log.h"
+#include "foundation/utility/string.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/frame.h"
+#include "renderer/api/log.h"
+#include "renderer/api/project.h"
+#include "renderer/api/rendering.h"
+#include "renderer/api/utility.h"
+
+// appleseed.maya headers.
+#include "appleseedmaya/halfconversion.h"
+#include "appleseedmaya/numautils.h"
+#include "appleseedmaya/sharedtilebuffer.h"
+#include "appleseedmaya/tiledexrwriter.h"
+
+namespace bfs = boost::filesystem;
+namespace asf = foundation;
+namespace asr = renderer;
+
+namespace
+{
+
+class SharedBufferRendererController
+  : public asr::DefaultRendererController
+{
+  public:
+    SharedBufferRendererController(
+        SharedTileBuffer*   buffer,
+        const double        timeLimit)
+      : m_buffer(buffer)
+      , m_timeLimit(static_cast<boost::uint64_t>(timeLimit * m_timer.frequency()))
+      , m_startTime(m_timer.read())
+    {
+    }
+
+    virtual void on_rendering_begin()
+    {
+        m_startTime = m_timer.read();
+    }
+
+    // Rendering is terminated, keeping the rendered frame, once the time limit is reached.
+    virtual Status get_status() const
+    {
+        if (m_buffer && m_buffer->abortRequested())
+            return AbortRendering;
+
+        if (m_timeLimit != 0 && m_timer.read() - m_startTime >= m_timeLimit)
+            return TerminateRendering;
+
+        return ContinueRendering;
+    }
+
+  private:
+    SharedTileBuffer*                           m_buffer;
+    mutable foundation::DefaultWallclockTimer   m_timer;
+    const boost::uint64_t                       m_timeLimit;    // Timer ticks, 0 if not limited.
+    boost::uint64_t                             m_startTime;
+};
+
+class SharedBufferTileCallback
+  : public asr::ITileCallback
+{
+  public:
+    explicit SharedBufferTileCallback(SharedTileBuffer& buffer)
+      : m_buffer(buffer)
+    {
+    }
+
+    virtual void release()
+    {
+        delete this;
+    }
+
+    virtual void pre_render(
+        const size_t        x,
+        const size_t        y,
+        const size_t        width,
+        const size_t        height)
+    {
+        m_buffer.writeHighlight(x, y, width, height);
+    }
+
+    virtual void post_render(
+        const asr::Frame*   frame)
+    {
+        const asf::CanvasProperties& frameProps = frame->image().properties();
+
+        for (size_t ty = 0; ty < frameProps.m_tile_count_y; ++ty)
+            for (size_t tx = 0; tx < frameProps.m_tile_count_x; ++tx)
+                write_tile(frame, tx, ty);
+    }
+
+    virtual void post_render_tile(
+        const asr::Frame*   frame,
+        const size_t        tile_x,
+        const size_t        tile_y)
+    {
+        write_tile(frame, tile_x, tile_y);
+    }
+
+  private:
+    void write_tile(
+        const asr::Frame*   frame,
+        const size_t        tile_x,
+        const size_t        tile_y)
+    {
+        const asf::Tile& tile = frame->image().tile(tile_x, tile_y);
+        const asf::CanvasProperties& frameProps = frame->image().properties();
+
+        const float* pixels = reinterpret_cast<const float*>(tile.get_storage());
+
+        // The shared buffer stores float pixels.
+        if (tile.get_pixel_format() == asf::PixelFormatHalf)
+        {
+            m_pixels.resize(4 * tile.get_pixel_count());
+            halfToFloat(
+                reinterpret_cast<const boost::uint16_t*>(tile.get_storage()),
+                &m_pixels[0],
+                m_pixels.size());
+            pixels = &m_pixels[0];
+        }
+
+        m_buffer.writeTile(
+            tile_x * frameProps.m_tile_width,
+            tile_y * frameProps.m_tile_height,
+            tile.get_width(),
+            tile.get_height(),
+            pixels);
+    }
+
+    SharedTileBuffer&   m_buffer;
+    std::vector<float>  m_pixels;
+};
+
+class SharedBufferTileCallbackFactory
+  : public asr::ITileCallbackFactory
+{
+  public:
+    explicit SharedBufferTileCallbackFactory(SharedTileBuffer& buffer)
+      : m_buffer(buffer)
+    {
+    }
+
+    virtual void release()
+    {
+        delete this;
+    }
+
+    virtual asr::ITileCallback* create()
+    {
+        return new SharedBufferTileCallback(m_buffer);
+    }
+
+  private:
+    SharedTileBuffer& m_buffer;
+};
+
+struct CommandLine
+{
+    CommandLine()
+      : m_crop(false)
+      , m_threads(0)
+      , m_timeLimit(0.0)
+    {
+    }
+
+    std::string m_project;
+    std::string m_sharedBuffer;
+    std::string m_output;
+    std::string m_schema;
+    bool        m_crop;
+    asf::AABB2u m_cropWindow;
+    int         m_threads;
+    std::string m_cpus;
+    double      m_timeLimit;
+};
+
+bool parseUnsigned(const char* arg, size_t& value)
+{
+    char* end;
+    const long x = std::strtol(arg, &end, 10);
+    if (*end != '\0' || x < 0)
+        return false;
+
+    value = static_cast<size_t>(x);
+    return true;
+}
+
+bool parseCommandLine(int argc, char* argv[], CommandLine& cl)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc)
+            cl.m_sharedBuffer = argv[++i];
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            cl.m_output = argv[++i];
+        else if (strcmp(argv[i], "--schema") == 0 && i + 1 < argc)
+            cl.m_schema = argv[++i];
+        else if (strcmp(argv[i], "--crop") == 0 && i + 4 < argc)
+        {
+            if (!parseUnsigned(argv[i + 1], cl.m_cropWindow.min.x) ||
+                !parseUnsigned(argv[i + 2], cl.m_cropWindow.min.y) ||
+                !parseUnsigned(argv[i + 3], cl.m_cropWindow.max.x) ||
+                !parseUnsigned(argv[i + 4], cl.m_cropWindow.max.y))
+            {
+                RENDERER_LOG_ERROR("appleseedMayaRender: invalid crop window");
+                return false;
+            }
+
+            cl.m_crop = true;
+            i += 4;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            cl.m_threads = std::atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc)
+            cl.m_cpus = argv[++i];
+        else if (strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc)
+            cl.m_timeLimit = std::max(std::atof(argv[++i]), 0.0);
+        else if (argv[i][0] != '-' && cl.m_project.empty())
+            cl.m_project = argv[i];
+        else
+        {
+            RENDERER_LOG_ERROR("appleseedMayaRender: unknown argument %s", argv[i]);
+            return false;
+        }
+    }
+
+    if (cl.m_project.empty())
+    {
+        RENDERER_LOG_ERROR(
+            "appleseedMayaRender: usage: appleseedMayaRender project.appleseed "
+            "[--shm name] [--output file] [--schema file] "
+            "[--crop xmin ymin xmax ymax] [--threads n] [--cpus list] "
+            "[--time-limit seconds]");
+        return false;
+    }
+
+    // Look for the schema next to the executable by default.
+    if (cl.m_schema.empty())
+    {
+        const bfs::path exePath = bfs::system_complete(argv[0]);
+        cl.m_schema = (exePath.parent_path() / "schemas" / "project.xsd").string();
+    }
+
+    return true;
+}
+
+bool writeImages(const asr::Frame& frame, const std::string& fileName)
+{
+    if (asf::ends_with(fileName, ".exr"))
+    {
+        TiledExrWriter writer;
+        return writer.open(fileName, frame) && writer.close(frame);
+    }
+
+    if (!frame.write_main_image(fileName.c_str()))
+        return false;
+
+    return frame.aov_images().size() == 0 || frame.write_aov_images(fileName.c_str());
+}
+
+int render(const CommandLine& cl)
+{
+    // Pin the process before loading the project, so that the scene
+    // is allocated in the memory of the NUMA node of the CPUs.
+    if (!cl.m_cpus.empty())
+    {
+        std::vector<size_t> cpus;
+        if (!NumaUtils::parseCpuList(cl.m_cpus, cpus) || !NumaUtils::setProcessAffinity(cpus))
+            RENDERER_LOG_WARNING("appleseedMayaRender: could not restrict the process to cpus %s", cl.m_cpus.c_str());
+    }
+
+    boost::scoped_ptr<SharedTileBuffer> buffer;
+    if (!cl.m_sharedBuffer.empty())
+    {
+        buffer.reset(SharedTileBuffer::open(cl.m_sharedBuffer));
+        if (!buffer)
+            return 1;
+    }
+
+    asr::ProjectFileReader reader;
+    asf::auto_release_ptr<asr::Project> project(
+        reader.read(cl.m_project.c_str(), cl.m_schema.c_str()));
+
+    if (project.get() == 0)
+    {
+        RENDERER_LOG_ERROR("appleseedMayaRender: could not read project %s", cl.m_project.c_str());
+
+        if (buffer)
+            buffer->setState(SharedTileBuffer::Failed);
+
+        return 1;
+    }
+
+    if (cl.m_crop)
+        project->get_frame()->set_crop_window(cl.m_cropWindow);
+
+    SharedBufferRendererController rendererController(buffer.get(), cl.m_timeLimit);
+
+    asf::auto_release_ptr<SharedBufferTileCallbackFactory> tileCallbackFactory;
+    if (buffer)
+        tileCallbackFactory.reset(new SharedBufferTileCallbackFactory(*buffer));
+
+    asr::ParamArray params =
+        project->configurations().get_by_name("final")->get_inherited_parameters();
+
+    if (cl.m_threads > 0)
+        params.insert_path("rendering_threads", cl.m_threads);
+
+    asr::MasterRenderer renderer(
+        *project,
+        params,
+        &rendererController,
+        static_cast<asr::ITileCallbackFactory*>(tileCallbackFactory.get()));
+
+    renderer.render();
+
+    if (rendererController.get_status() == asr::IRendererController::AbortRendering)
+    {
+        RENDERER_LOG_INFO("appleseedMayaRender: render aborted.");
+
+        if (buffer)
+            buffer->setState(SharedTileBuffer::Done);
+
+        return 0;
+    }
+
+    if (!cl.m_output.empty() && !writeImages(*project->get_frame(), cl.m_output))
+    {
+        if (buffer)
+            buffer->setState(SharedTileBuffer::Failed);
+
+        return 1;
+    }
+
+    if (buffer)
+        buffer->setState(SharedTileBuffer::Done);
+
+    return 0;
+}
+
+} // unnamed.
+
+int main(int argc, char* argv[])
+{
+    asf::auto_release_ptr<asf::ILogTarget> logTarget(asf::create_console_log_target(stderr));
+    asr::global_logger().add_target(logTarget.get());
+
+    CommandLine cl;
+    if (!parseCommandLine(argc, argv, cl))
+        return 1;
+
+    int result = 1;
+
+    try
+    {
+        result = render(cl);
+    }
+    catch (const std::exception& e)
+    {
+        RENDERER_LOG_ERROR("appleseedMayaRender: %s", e.what());
+    }
+
+    asr::global_logger().remove_target(logTarget.get());
+    return result;
+}
@@ -0,0 +1,296 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2016-2017 Esteban Tovagliari, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//
+// Micro-benchmark of the render view display transform.
+//
+//  Times DisplayTransform::apply on a frame of random HDR pixels and compares
+//  it with a per-pixel evaluation of the same curves, which is also used to
+//  measure the error of the lookup tables.
+//
+//  Also times the render view tile path: the current row copy followed by the
+//  display transform, against the previous per-pixel Tile::get_component copy.
+//
+//  Usage: displayTransformBenchmark [width height [iterations]]
+//
+//  This file does not depend on Maya.
+//
+
+// appleseed.maya headers.
+#include "appleseedmaya/displaytransform.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/pixel.h"
+#include "foundation/image/tile.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+namespace asf = foundation;
+
+namespace
+{
+
+//
+// Reference per-pixel implementation.
+//
+
+float srgb(const float x)
+{
+    return x <= 0.0031308f ? 12.92f * x : 1.055f * std::pow(x, 1.0f / 2.4f) - 0.055f;
+}
+
+float rec709(const float x)
+{
+    return x < 0.018f ? 4.5f * x : 1.099f * std::pow(x, 0.45f) - 0.099f;
+}
+
+float hable(const float x)
+{
+    const float A = 0.15f, B = 0.50f, C = 0.10f, D = 0.20f, E = 0.02f, F = 0.30f;
+    return ((x * (A * x + C * B) + D * E) / (x * (A * x + B) + D * F)) - E / F;
+}
+
+float filmic(const float x)
+{
+    const float WhitePoint = 11.2f;
+    return srgb(std::min(hable(x) / hable(WhitePoint), 1.0f));
+}
+
+void applyReference(
+    const DisplayTransform::Curve   curve,
+    const float                     scale,
+    const float*                    src,
+    float*                          dst,
+    const size_t                    pixelCount)
+{
+    for (size_t i = 0; i < pixelCount; ++i, src += 4, dst += 4)
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            const float x = std::max(src[c] * scale, 0.0f);
+
+            switch (curve)
+            {
+              case DisplayTransform::SRGB:
+                dst[c] = srgb(std::min(x, 1.0f));
+                break;
+
+              case DisplayTransform::Rec709:
+                dst[c] = rec709(std::min(x, 1.0f));
+                break;
+
+              case DisplayTransform::Filmic:
+                dst[c] = filmic(x);
+                break;
+
+              default:
+                dst[c] = x;
+                break;
+            }
+        }
+
+        dst[3] = std::min(std::max(src[3], 0.0f), 1.0f);
+    }
+}
+
+//
+// Render view tile copies.
+//
+
+// Same layout as Maya's RV_PIXEL.
+struct RenderViewPixel
+{
+    float r, g, b, a;
+};
+
+// Previous tile path: per-pixel copy with Tile::get_component, flipped vertically.
+void copyTileGetComponent(const asf::Tile& tile, RenderViewPixel* dst)
+{
+    for (size_t y = tile.get_height(); y-- > 0;)
+    {
+        for (size_t x = 0, w = tile.get_width(); x < w; ++x)
+        {
+            dst->r = tile.get_component<float>(x, y, 0);
+            dst->g = tile.get_component<float>(x, y, 1);
+            dst->b = tile.get_component<float>(x, y, 2);
+            dst->a = tile.get_component<float>(x, y, 3);
+            ++dst;
+        }
+    }
+}
+
+// Current tile path: row copies, flipped vertically, then the display transform.
+void copyTileRows(
+    const asf::Tile&            tile,
+    const DisplayTransform&     transform,
+    RenderViewPixel*            dst)
+{
+    const size_t w = tile.get_width();
+    const float* src = reinterpret_cast<const float*>(tile.get_storage());
+
+    RenderViewPixel* p = dst;
+    for (size_t y = tile.get_height(); y-- > 0; p += w)
+        std::memcpy(p, src + y * w * 4, w * sizeof(RenderViewPixel));
+
+    if (!transform.isIdentity())
+    {
+        float* rgba = reinterpret_cast<float*>(dst);
+        transform.apply(rgba, rgba, tile.get_pixel_count());
+    }
+}
+
+double elapsedMilliseconds(const std::clock_t start)
+{
+    return 1000.0 * static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+} // unnamed.
+
+int main(int argc, char* argv[])
+{
+    size_t width = 4096;
+    size_t height = 2160;
+    int iterations = 10;
+
+    if (argc >= 3)
+    {
+        width = static_cast<size_t>(std::atoi(argv[1]));
+        height = static_cast<size_t>(std::atoi(argv[2]));
+    }
+
+    if (argc >= 4)
+        iterations = std::max(std::atoi(argv[3]), 1);
+
+    const size_t pixelCount = width * height;
+    if (pixelCount == 0)
+    {
+        std::fprintf(stderr, "Usage: %s [width height [iterations]]\n", argv[0]);
+        return 1;
+    }
+
+    // Random HDR pixels, fixed seed so that runs are comparable.
+    std::vector<float> src(pixelCount * 4);
+    std::srand(1);
+    for (size_t i = 0, e = src.size(); i < e; ++i)
+        src[i] = 16.0f * static_cast<float>(std::rand()) / RAND_MAX - 0.5f;
+
+    std::vector<float> dst(src.size());
+    std::vector<float> ref(src.size());
+
+    std::printf(
+        "%s code path, %ux%u pixels, best of %d iterations.\n",
+#if defined(APPLESEED_MAYA_NO_SSE2)
+        "scalar",
+#else
+        "SSE2 (when available)",
+#endif
+        static_cast<unsigned int>(width),
+        static_cast<unsigned int>(height),
+        iterations);
+
+    const char* curveNames[] = { "linear", "srgb", "rec709", "filmic" };
+    const float exposure = 0.5f;
+    const float scale = std::pow(2.0f, exposure);
+
+    for (int curve = DisplayTransform::Linear; curve <= DisplayTransform::Filmic; ++curve)
+    {
+        const DisplayTransform transform(static_cast<DisplayTransform::Curve>(curve), exposure);
+
+        double best = 1.0e+30, bestRef = 1.0e+30;
+        for (int i = 0; i < iterations; ++i)
+        {
+            std::clock_t start = std::clock();
+            transform.apply(&src[0], &dst[0], pixelCount);
+            best = std::min(best, elapsedMilliseconds(start));
+
+            start = std::clock();
+            applyReference(static_cast<DisplayTransform::Curve>(curve), scale, &src[0], &ref[0], pixelCount);
+            bestRef = std::min(bestRef, elapsedMilliseconds(start));
+        }
+
+        float maxError = 0.0f;
+        for (size_t i = 0, e = dst.size(); i < e; ++i)
+            maxError = std::max(maxError, std::abs(dst[i] - ref[i]));
+
+        std::printf(
+            "  %-8s apply %8.2f ms   per-pixel %8.2f ms   max error %g\n",
+            curveNames[curve],
+            best,
+            bestRef,
+            maxError);
+    }
+
+    // Render view tile path, on the same number of pixels in 64x64 tiles.
+    const size_t TileSize = 64;
+    const size_t tileCount = std::max<size_t>(pixelCount / (TileSize * TileSize), 1);
+
+    asf::Tile tile(TileSize, TileSize, 4, asf::PixelFormatFloat);
+    std::memcpy(
+        tile.get_storage(),
+        &src[0],
+        std::min(src.size(), tile.get_pixel_count() * 4) * sizeof(float));
+
+    std::vector<RenderViewPixel> tilePixels(tile.get_pixel_count());
+    const DisplayTransform identity(DisplayTransform::Linear, 0.0f);
+    const DisplayTransform srgbTransform(DisplayTransform::SRGB, exposure);
+
+    double bestGetComponent = 1.0e+30, bestRows = 1.0e+30, bestRowsSRGB = 1.0e+30;
+    for (int i = 0; i < iterations; ++i)
+    {
+        std::clock_t start = std::clock();
+        for (size_t t = 0; t < tileCount; ++t)
+            copyTileGetComponent(tile, &tilePixels[0]);
+        bestGetComponent = std::min(bestGetComponent, elapsedMilliseconds(start));
+
+        start = std::clock();
+        for (size_t t = 0; t < tileCount; ++t)
+            copyTileRows(tile, identity, &tilePixels[0]);
+        bestRows = std::min(bestRows, elapsedMilliseconds(start));
+
+        start = std::clock();
+        for (size_t t = 0; t < tileCount; ++t)
+            copyTileRows(tile, srgbTransform, &tilePixels[0]);
+        bestRowsSRGB = std::min(bestRowsSRGB, elapsedMilliseconds(start));
+    }
+
+    std::printf(
+        "  tiles    get_component %8.2f ms   rows %8.2f ms   rows + srgb %8.2f ms\n",
+        bestGetComponent,
+        bestRows,
+        bestRowsSRGB);
+
+    return 0;
+}